@@ -0,0 +1,96 @@
+//======================================
+// TECHRAD text formatting
+// Digits are written backwards into a scratch buffer, then copied
+//======================================
+
+#include "format.h"
+
+static const char s_weekdays[7][4] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+
+
+//======================================
+// BUILDING BLOCKS
+//======================================
+size_t format_text(char *buffer, size_t size, const char *text) {
+    size_t length = 0;
+    if (size == 0) {
+        return 0;
+    }
+    while ((text[length] != '\0') && (length < size - 1)) {
+        buffer[length] = text[length];
+        length++;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+size_t format_int(char *buffer, size_t size, int32_t value) {
+    char digits[12]; // sign and 10 digits of INT32_MIN, plus the NUL
+    char *cursor = digits + sizeof(digits) - 1;
+    uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+
+    *cursor = '\0';
+    do {
+        *--cursor = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        *--cursor = '-';
+    }
+    return format_text(buffer, size, cursor);
+}
+
+// two digits with a leading zero, values are 0 to 99
+static size_t format_two_digits(char *buffer, size_t size, int value) {
+    char digits[3] = { '0' + value / 10, '0' + value % 10, '\0' };
+    return format_text(buffer, size, digits);
+}
+
+
+//======================================
+// LABELS
+//======================================
+size_t format_battery(char *buffer, size_t size, uint8_t percent, bool charging, uint8_t marks) {
+    static const char *const stage_marks[] = { "", "!", "!!", "!!!" };
+    size_t length = 0;
+    if (charging) {
+        length = format_text(buffer, size, "+");
+        return length + format_int(buffer + length, size - length, percent);
+    }
+    length = format_int(buffer, size, percent);
+    if (marks >= ARRAY_LENGTH(stage_marks)) {
+        marks = ARRAY_LENGTH(stage_marks) - 1;
+    }
+    return length + format_text(buffer + length, size - length, stage_marks[marks]);
+}
+
+size_t format_temperature(char *buffer, size_t size, int32_t value) {
+    static const char degree[] = "\u00B0";
+    size_t length = format_int(buffer, size, value);
+    if (size - length < sizeof(degree)) {
+        return length; // half a UTF-8 sequence would show as garbage
+    }
+    return length + format_text(buffer + length, size - length, degree);
+}
+
+size_t format_fitness(char *buffer, size_t size, int32_t value, bool distance) {
+    size_t length = format_int(buffer, size, value);
+    return length + format_text(buffer + length, size - length, distance ? " m" : "x");
+}
+
+size_t format_day(char *buffer, size_t size, const struct tm *t) {
+    size_t length = format_text(buffer, size, s_weekdays[t->tm_wday % 7]);
+    length += format_text(buffer + length, size - length, " ");
+    return length + format_two_digits(buffer + length, size - length, t->tm_mday);
+}
+
+size_t format_clock(char *buffer, size_t size, int hour, int minute, bool clock24) {
+    int shown = clock24 ? hour : ((hour % 12 == 0) ? 12 : hour % 12);
+    size_t length = format_int(buffer, size, shown);
+    length += format_text(buffer + length, size - length, ":");
+    length += format_two_digits(buffer + length, size - length, minute);
+    if (!clock24) {
+        length += format_text(buffer + length, size - length, (hour < 12) ? " AM" : " PM");
+    }
+    return length;
+}
@@ -0,0 +1,34 @@
+//======================================
+// TECHRAD text formatting
+// Small fixed-buffer formatters for the label strings,
+// used instead of snprintf and strftime on the redraw paths
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+// every formatter writes at most size bytes including the NUL, text that
+// doesn't fit is cut, and returns the length of the string it wrote
+// the result of one call can be appended to with buffer + length, size - length
+
+// decimal integer, "-" for negative values
+size_t format_int(char *buffer, size_t size, int32_t value);
+
+// plain copy of text
+size_t format_text(char *buffer, size_t size, const char *text);
+
+// battery percentage, "+NN" while charging, otherwise NN and one "!" per power stage
+size_t format_battery(char *buffer, size_t size, uint8_t percent, bool charging, uint8_t marks);
+
+// temperature in degrees "N°", the two byte degree sign is left off whole if it doesn't fit
+size_t format_temperature(char *buffer, size_t size, int32_t value);
+
+// distance walked "N m" or steps "Nx"
+size_t format_fitness(char *buffer, size_t size, int32_t value, bool distance);
+
+// day of the week and day of the month, "Mon 07" like strftime "%a %d"
+size_t format_day(char *buffer, size_t size, const struct tm *t);
+
+// time of day, "H:MM" in 24 hour style or "H:MM AM"
+size_t format_clock(char *buffer, size_t size, int hour, int minute, bool clock24);
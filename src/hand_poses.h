@@ -0,0 +1,285 @@
+// generated by tools/generate_hand_poses.py from techrad.h, do not edit
+// hand points are offsets from the screen center, already rotated
+
+#pragma once
+
+#include "pebble.h"
+
+#define MINUTE_HAND_POSE_POINTS 10
+#define HOUR_HAND_POSE_POINTS 5
+#define MINUTE_HAND_POSES 60
+#define HOUR_HAND_POSES 144 // index is (hour % 12) * 12 + minute / 5
+#define SECOND_HAND_POSES 60
+
+static const int8_t MINUTE_HAND_POSE[MINUTE_HAND_POSES][MINUTE_HAND_POSE_POINTS][2] = {
+  { { -7, 0 }, { -7, -62 }, { 0, -74 }, { 7, -62 }, { 7, 0 }, { 2, 0 }, { 2, -48 }, { 0, -65 }, { -2, -48 }, { -2, 0 } }, // 0
+  { { -7, -1 }, { 0, -62 }, { 8, -74 }, { 13, -61 }, { 7, 1 }, { 2, 0 }, { 7, -48 }, { 7, -65 }, { 3, -48 }, { -2, 0 } }, // 1
+  { { -7, -1 }, { 6, -62 }, { 15, -72 }, { 20, -59 }, { 7, 1 }, { 2, 0 }, { 12, -47 }, { 14, -64 }, { 8, -47 }, { -2, 0 } }, // 2
+  { { -7, -2 }, { 12, -61 }, { 23, -70 }, { 26, -57 }, { 7, 2 }, { 2, 1 }, { 17, -45 }, { 20, -62 }, { 13, -46 }, { -2, -1 } }, // 3
+  { { -6, -3 }, { 19, -59 }, { 30, -68 }, { 32, -54 }, { 6, 3 }, { 2, 1 }, { 21, -43 }, { 26, -59 }, { 18, -45 }, { -2, -1 } }, // 4
+  { { -6, -3 }, { 25, -57 }, { 37, -64 }, { 37, -50 }, { 6, 3 }, { 2, 1 }, { 26, -41 }, { 32, -56 }, { 22, -43 }, { -2, -1 } }, // 5
+  { { -6, -4 }, { 31, -54 }, { 43, -60 }, { 42, -46 }, { 6, 4 }, { 2, 1 }, { 30, -38 }, { 38, -53 }, { 27, -40 }, { -2, -1 } }, // 6
+  { { -5, -5 }, { 36, -51 }, { 50, -55 }, { 47, -41 }, { 5, 5 }, { 1, 1 }, { 34, -34 }, { 43, -48 }, { 31, -37 }, { -1, -1 } }, // 7
+  { { -5, -5 }, { 41, -47 }, { 55, -50 }, { 51, -36 }, { 5, 5 }, { 1, 1 }, { 37, -31 }, { 48, -43 }, { 34, -34 }, { -1, -1 } }, // 8
+  { { -4, -6 }, { 46, -42 }, { 60, -43 }, { 54, -31 }, { 4, 6 }, { 1, 2 }, { 40, -27 }, { 53, -38 }, { 38, -30 }, { -1, -2 } }, // 9
+  { { -4, -6 }, { 50, -37 }, { 64, -37 }, { 57, -25 }, { 4, 6 }, { 1, 2 }, { 43, -22 }, { 56, -33 }, { 41, -26 }, { -1, -2 } }, // 10
+  { { -3, -6 }, { 54, -32 }, { 68, -30 }, { 59, -19 }, { 3, 6 }, { 1, 2 }, { 45, -18 }, { 59, -26 }, { 43, -21 }, { -1, -2 } }, // 11
+  { { -2, -7 }, { 57, -26 }, { 70, -23 }, { 61, -13 }, { 2, 7 }, { 1, 2 }, { 46, -13 }, { 62, -20 }, { 45, -17 }, { -1, -2 } }, // 12
+  { { -1, -7 }, { 59, -20 }, { 72, -15 }, { 62, -6 }, { 1, 7 }, { 0, 2 }, { 47, -8 }, { 64, -14 }, { 47, -12 }, { 0, -2 } }, // 13
+  { { -1, -7 }, { 61, -13 }, { 74, -8 }, { 62, 0 }, { 1, 7 }, { 0, 2 }, { 48, -3 }, { 65, -7 }, { 48, -7 }, { 0, -2 } }, // 14
+  { { 0, -7 }, { 62, -7 }, { 74, 0 }, { 62, 7 }, { 0, 7 }, { 0, 2 }, { 48, 2 }, { 65, 0 }, { 48, -2 }, { 0, -2 } }, // 15
+  { { 1, -7 }, { 62, 0 }, { 74, 8 }, { 61, 13 }, { -1, 7 }, { 0, 2 }, { 48, 7 }, { 65, 7 }, { 48, 3 }, { 0, -2 } }, // 16
+  { { 1, -7 }, { 62, 6 }, { 72, 15 }, { 59, 20 }, { -1, 7 }, { 0, 2 }, { 47, 12 }, { 64, 14 }, { 47, 8 }, { 0, -2 } }, // 17
+  { { 2, -7 }, { 61, 12 }, { 70, 23 }, { 57, 26 }, { -2, 7 }, { -1, 2 }, { 45, 17 }, { 62, 20 }, { 46, 13 }, { 1, -2 } }, // 18
+  { { 3, -6 }, { 59, 19 }, { 68, 30 }, { 54, 32 }, { -3, 6 }, { -1, 2 }, { 43, 21 }, { 59, 26 }, { 45, 18 }, { 1, -2 } }, // 19
+  { { 3, -6 }, { 57, 25 }, { 64, 37 }, { 50, 37 }, { -3, 6 }, { -1, 2 }, { 41, 26 }, { 56, 32 }, { 43, 22 }, { 1, -2 } }, // 20
+  { { 4, -6 }, { 54, 31 }, { 60, 43 }, { 46, 42 }, { -4, 6 }, { -1, 2 }, { 38, 30 }, { 53, 38 }, { 40, 27 }, { 1, -2 } }, // 21
+  { { 5, -5 }, { 51, 36 }, { 55, 50 }, { 41, 47 }, { -5, 5 }, { -1, 1 }, { 34, 34 }, { 48, 43 }, { 37, 31 }, { 1, -1 } }, // 22
+  { { 5, -5 }, { 47, 41 }, { 50, 55 }, { 36, 51 }, { -5, 5 }, { -1, 1 }, { 31, 37 }, { 43, 48 }, { 34, 34 }, { 1, -1 } }, // 23
+  { { 6, -4 }, { 42, 46 }, { 43, 60 }, { 31, 54 }, { -6, 4 }, { -2, 1 }, { 27, 40 }, { 38, 53 }, { 30, 38 }, { 2, -1 } }, // 24
+  { { 6, -4 }, { 37, 50 }, { 37, 64 }, { 25, 57 }, { -6, 4 }, { -2, 1 }, { 22, 43 }, { 33, 56 }, { 26, 41 }, { 2, -1 } }, // 25
+  { { 6, -3 }, { 32, 54 }, { 30, 68 }, { 19, 59 }, { -6, 3 }, { -2, 1 }, { 18, 45 }, { 26, 59 }, { 21, 43 }, { 2, -1 } }, // 26
+  { { 7, -2 }, { 26, 57 }, { 23, 70 }, { 13, 61 }, { -7, 2 }, { -2, 1 }, { 13, 46 }, { 20, 62 }, { 17, 45 }, { 2, -1 } }, // 27
+  { { 7, -1 }, { 20, 59 }, { 15, 72 }, { 6, 62 }, { -7, 1 }, { -2, 0 }, { 8, 47 }, { 14, 64 }, { 12, 47 }, { 2, 0 } }, // 28
+  { { 7, -1 }, { 13, 61 }, { 8, 74 }, { 0, 62 }, { -7, 1 }, { -2, 0 }, { 3, 48 }, { 7, 65 }, { 7, 48 }, { 2, 0 } }, // 29
+  { { 7, 0 }, { 7, 62 }, { 0, 74 }, { -7, 62 }, { -7, 0 }, { -2, 0 }, { -2, 48 }, { 0, 65 }, { 2, 48 }, { 2, 0 } }, // 30
+  { { 7, 1 }, { 0, 62 }, { -8, 74 }, { -13, 61 }, { -7, -1 }, { -2, 0 }, { -7, 48 }, { -7, 65 }, { -3, 48 }, { 2, 0 } }, // 31
+  { { 7, 1 }, { -6, 62 }, { -15, 72 }, { -20, 59 }, { -7, -1 }, { -2, 0 }, { -12, 47 }, { -14, 64 }, { -8, 47 }, { 2, 0 } }, // 32
+  { { 7, 2 }, { -12, 61 }, { -23, 70 }, { -26, 57 }, { -7, -2 }, { -2, -1 }, { -17, 45 }, { -20, 62 }, { -13, 46 }, { 2, 1 } }, // 33
+  { { 6, 3 }, { -19, 59 }, { -30, 68 }, { -32, 54 }, { -6, -3 }, { -2, -1 }, { -21, 43 }, { -26, 59 }, { -18, 45 }, { 2, 1 } }, // 34
+  { { 6, 3 }, { -25, 57 }, { -37, 64 }, { -37, 50 }, { -6, -3 }, { -2, -1 }, { -26, 41 }, { -32, 56 }, { -22, 43 }, { 2, 1 } }, // 35
+  { { 6, 4 }, { -31, 54 }, { -43, 60 }, { -42, 46 }, { -6, -4 }, { -2, -1 }, { -30, 38 }, { -38, 53 }, { -27, 40 }, { 2, 1 } }, // 36
+  { { 5, 5 }, { -36, 51 }, { -50, 55 }, { -47, 41 }, { -5, -5 }, { -1, -1 }, { -34, 34 }, { -43, 48 }, { -31, 37 }, { 1, 1 } }, // 37
+  { { 5, 5 }, { -41, 47 }, { -55, 50 }, { -51, 36 }, { -5, -5 }, { -1, -1 }, { -37, 31 }, { -48, 43 }, { -34, 34 }, { 1, 1 } }, // 38
+  { { 4, 6 }, { -46, 42 }, { -60, 43 }, { -54, 31 }, { -4, -6 }, { -1, -2 }, { -40, 27 }, { -53, 38 }, { -38, 30 }, { 1, 2 } }, // 39
+  { { 4, 6 }, { -50, 37 }, { -64, 37 }, { -57, 25 }, { -4, -6 }, { -1, -2 }, { -43, 22 }, { -56, 33 }, { -41, 26 }, { 1, 2 } }, // 40
+  { { 3, 6 }, { -54, 32 }, { -68, 30 }, { -59, 19 }, { -3, -6 }, { -1, -2 }, { -45, 18 }, { -59, 26 }, { -43, 21 }, { 1, 2 } }, // 41
+  { { 2, 7 }, { -57, 26 }, { -70, 23 }, { -61, 13 }, { -2, -7 }, { -1, -2 }, { -46, 13 }, { -62, 20 }, { -45, 17 }, { 1, 2 } }, // 42
+  { { 1, 7 }, { -59, 20 }, { -72, 15 }, { -62, 6 }, { -1, -7 }, { 0, -2 }, { -47, 8 }, { -64, 14 }, { -47, 12 }, { 0, 2 } }, // 43
+  { { 1, 7 }, { -61, 13 }, { -74, 8 }, { -62, 0 }, { -1, -7 }, { 0, -2 }, { -48, 3 }, { -65, 7 }, { -48, 7 }, { 0, 2 } }, // 44
+  { { 0, 7 }, { -62, 7 }, { -74, 0 }, { -62, -7 }, { 0, -7 }, { 0, -2 }, { -48, -2 }, { -65, 0 }, { -48, 2 }, { 0, 2 } }, // 45
+  { { -1, 7 }, { -62, 0 }, { -74, -8 }, { -61, -13 }, { 1, -7 }, { 0, -2 }, { -48, -7 }, { -65, -7 }, { -48, -3 }, { 0, 2 } }, // 46
+  { { -1, 7 }, { -62, -6 }, { -72, -15 }, { -59, -20 }, { 1, -7 }, { 0, -2 }, { -47, -12 }, { -64, -14 }, { -47, -8 }, { 0, 2 } }, // 47
+  { { -2, 7 }, { -61, -12 }, { -70, -23 }, { -57, -26 }, { 2, -7 }, { 1, -2 }, { -45, -17 }, { -62, -20 }, { -46, -13 }, { -1, 2 } }, // 48
+  { { -3, 6 }, { -59, -19 }, { -68, -30 }, { -54, -32 }, { 3, -6 }, { 1, -2 }, { -43, -21 }, { -59, -26 }, { -45, -18 }, { -1, 2 } }, // 49
+  { { -3, 6 }, { -57, -25 }, { -64, -37 }, { -50, -37 }, { 3, -6 }, { 1, -2 }, { -41, -26 }, { -56, -32 }, { -43, -22 }, { -1, 2 } }, // 50
+  { { -4, 6 }, { -54, -31 }, { -60, -43 }, { -46, -42 }, { 4, -6 }, { 1, -2 }, { -38, -30 }, { -53, -38 }, { -40, -27 }, { -1, 2 } }, // 51
+  { { -5, 5 }, { -51, -36 }, { -55, -50 }, { -41, -47 }, { 5, -5 }, { 1, -1 }, { -34, -34 }, { -48, -43 }, { -37, -31 }, { -1, 1 } }, // 52
+  { { -5, 5 }, { -47, -41 }, { -50, -55 }, { -36, -51 }, { 5, -5 }, { 1, -1 }, { -31, -37 }, { -43, -48 }, { -34, -34 }, { -1, 1 } }, // 53
+  { { -6, 4 }, { -42, -46 }, { -43, -60 }, { -31, -54 }, { 6, -4 }, { 2, -1 }, { -27, -40 }, { -38, -53 }, { -30, -38 }, { -2, 1 } }, // 54
+  { { -6, 4 }, { -37, -50 }, { -37, -64 }, { -25, -57 }, { 6, -4 }, { 2, -1 }, { -22, -43 }, { -33, -56 }, { -26, -41 }, { -2, 1 } }, // 55
+  { { -6, 3 }, { -32, -54 }, { -30, -68 }, { -19, -59 }, { 6, -3 }, { 2, -1 }, { -18, -45 }, { -26, -59 }, { -21, -43 }, { -2, 1 } }, // 56
+  { { -7, 2 }, { -26, -57 }, { -23, -70 }, { -13, -61 }, { 7, -2 }, { 2, -1 }, { -13, -46 }, { -20, -62 }, { -17, -45 }, { -2, 1 } }, // 57
+  { { -7, 1 }, { -20, -59 }, { -15, -72 }, { -6, -62 }, { 7, -1 }, { 2, 0 }, { -8, -47 }, { -14, -64 }, { -12, -47 }, { -2, 0 } }, // 58
+  { { -7, 1 }, { -13, -61 }, { -8, -74 }, { 0, -62 }, { 7, -1 }, { 2, 0 }, { -3, -48 }, { -7, -65 }, { -7, -48 }, { -2, 0 } }, // 59
+};
+
+static const int8_t HOUR_HAND_POSE[HOUR_HAND_POSES][HOUR_HAND_POSE_POINTS][2] = {
+  { { -7, 0 }, { -7, -55 }, { 0, -65 }, { 7, -55 }, { 7, 0 } }, // 0:00
+  { { -7, 0 }, { -5, -55 }, { 3, -65 }, { 9, -55 }, { 7, 0 } }, // 0:05
+  { { -7, -1 }, { -2, -55 }, { 6, -65 }, { 12, -54 }, { 7, 1 } }, // 0:10
+  { { -7, -1 }, { 0, -55 }, { 8, -64 }, { 14, -54 }, { 7, 1 } }, // 0:15
+  { { -7, -1 }, { 3, -55 }, { 11, -64 }, { 16, -53 }, { 7, 1 } }, // 0:20
+  { { -7, -2 }, { 5, -55 }, { 14, -63 }, { 19, -52 }, { 7, 2 } }, // 0:25
+  { { -7, -2 }, { 7, -55 }, { 17, -63 }, { 21, -51 }, { 7, 2 } }, // 0:30
+  { { -7, -2 }, { 10, -55 }, { 20, -62 }, { 23, -50 }, { 7, 2 } }, // 0:35
+  { { -7, -2 }, { 12, -54 }, { 22, -61 }, { 25, -49 }, { 7, 2 } }, // 0:40
+  { { -6, -3 }, { 15, -53 }, { 25, -60 }, { 28, -48 }, { 6, 3 } }, // 0:45
+  { { -6, -3 }, { 17, -53 }, { 27, -59 }, { 30, -47 }, { 6, 3 } }, // 0:50
+  { { -6, -3 }, { 19, -52 }, { 30, -58 }, { 32, -46 }, { 6, 3 } }, // 0:55
+  { { -6, -3 }, { 21, -51 }, { 32, -56 }, { 34, -44 }, { 6, 3 } }, // 1:00
+  { { -6, -4 }, { 24, -50 }, { 35, -55 }, { 35, -43 }, { 6, 4 } }, // 1:05
+  { { -6, -4 }, { 26, -49 }, { 37, -53 }, { 37, -41 }, { 6, 4 } }, // 1:10
+  { { -6, -4 }, { 28, -48 }, { 40, -52 }, { 39, -39 }, { 6, 4 } }, // 1:15
+  { { -5, -4 }, { 30, -47 }, { 42, -50 }, { 41, -38 }, { 5, 4 } }, // 1:20
+  { { -5, -5 }, { 32, -45 }, { 44, -48 }, { 42, -36 }, { 5, 5 } }, // 1:25
+  { { -5, -5 }, { 34, -44 }, { 46, -46 }, { 44, -34 }, { 5, 5 } }, // 1:30
+  { { -5, -5 }, { 36, -42 }, { 48, -44 }, { 45, -32 }, { 5, 5 } }, // 1:35
+  { { -4, -5 }, { 38, -41 }, { 50, -42 }, { 47, -30 }, { 4, 5 } }, // 1:40
+  { { -4, -6 }, { 39, -39 }, { 52, -40 }, { 48, -28 }, { 4, 6 } }, // 1:45
+  { { -4, -6 }, { 41, -37 }, { 53, -37 }, { 49, -26 }, { 4, 6 } }, // 1:50
+  { { -4, -6 }, { 43, -35 }, { 55, -35 }, { 50, -24 }, { 4, 6 } }, // 1:55
+  { { -4, -6 }, { 44, -34 }, { 56, -33 }, { 51, -21 }, { 4, 6 } }, // 2:00
+  { { -3, -6 }, { 46, -32 }, { 58, -30 }, { 52, -19 }, { 3, 6 } }, // 2:05
+  { { -3, -6 }, { 47, -30 }, { 59, -27 }, { 53, -17 }, { 3, 6 } }, // 2:10
+  { { -3, -6 }, { 48, -28 }, { 60, -25 }, { 53, -15 }, { 3, 6 } }, // 2:15
+  { { -2, -7 }, { 49, -25 }, { 61, -22 }, { 54, -12 }, { 2, 7 } }, // 2:20
+  { { -2, -7 }, { 50, -23 }, { 62, -20 }, { 55, -10 }, { 2, 7 } }, // 2:25
+  { { -2, -7 }, { 51, -21 }, { 63, -17 }, { 55, -7 }, { 2, 7 } }, // 2:30
+  { { -2, -7 }, { 52, -19 }, { 63, -14 }, { 55, -5 }, { 2, 7 } }, // 2:35
+  { { -1, -7 }, { 53, -16 }, { 64, -11 }, { 55, -3 }, { 1, 7 } }, // 2:40
+  { { -1, -7 }, { 54, -14 }, { 64, -8 }, { 55, 0 }, { 1, 7 } }, // 2:45
+  { { -1, -7 }, { 54, -12 }, { 65, -6 }, { 55, 2 }, { 1, 7 } }, // 2:50
+  { { 0, -7 }, { 55, -9 }, { 65, -3 }, { 55, 5 }, { 0, 7 } }, // 2:55
+  { { 0, -7 }, { 55, -7 }, { 65, 0 }, { 55, 7 }, { 0, 7 } }, // 3:00
+  { { 0, -7 }, { 55, -5 }, { 65, 3 }, { 55, 9 }, { 0, 7 } }, // 3:05
+  { { 1, -7 }, { 55, -2 }, { 65, 6 }, { 54, 12 }, { -1, 7 } }, // 3:10
+  { { 1, -7 }, { 55, 0 }, { 64, 8 }, { 54, 14 }, { -1, 7 } }, // 3:15
+  { { 1, -7 }, { 55, 3 }, { 64, 11 }, { 53, 16 }, { -1, 7 } }, // 3:20
+  { { 2, -7 }, { 55, 5 }, { 63, 14 }, { 52, 19 }, { -2, 7 } }, // 3:25
+  { { 2, -7 }, { 55, 7 }, { 63, 17 }, { 51, 21 }, { -2, 7 } }, // 3:30
+  { { 2, -7 }, { 55, 10 }, { 62, 20 }, { 50, 23 }, { -2, 7 } }, // 3:35
+  { { 2, -7 }, { 54, 12 }, { 61, 22 }, { 49, 25 }, { -2, 7 } }, // 3:40
+  { { 3, -6 }, { 53, 15 }, { 60, 25 }, { 48, 28 }, { -3, 6 } }, // 3:45
+  { { 3, -6 }, { 53, 17 }, { 59, 27 }, { 47, 30 }, { -3, 6 } }, // 3:50
+  { { 3, -6 }, { 52, 19 }, { 58, 30 }, { 46, 32 }, { -3, 6 } }, // 3:55
+  { { 3, -6 }, { 51, 21 }, { 56, 32 }, { 44, 34 }, { -3, 6 } }, // 4:00
+  { { 4, -6 }, { 50, 24 }, { 55, 35 }, { 43, 35 }, { -4, 6 } }, // 4:05
+  { { 4, -6 }, { 49, 26 }, { 53, 37 }, { 41, 37 }, { -4, 6 } }, // 4:10
+  { { 4, -6 }, { 48, 28 }, { 52, 40 }, { 39, 39 }, { -4, 6 } }, // 4:15
+  { { 4, -5 }, { 47, 30 }, { 50, 42 }, { 38, 41 }, { -4, 5 } }, // 4:20
+  { { 5, -5 }, { 45, 32 }, { 48, 44 }, { 36, 42 }, { -5, 5 } }, // 4:25
+  { { 5, -5 }, { 44, 34 }, { 46, 46 }, { 34, 44 }, { -5, 5 } }, // 4:30
+  { { 5, -5 }, { 42, 36 }, { 44, 48 }, { 32, 45 }, { -5, 5 } }, // 4:35
+  { { 5, -4 }, { 41, 38 }, { 42, 50 }, { 30, 47 }, { -5, 4 } }, // 4:40
+  { { 6, -4 }, { 39, 39 }, { 40, 52 }, { 28, 48 }, { -6, 4 } }, // 4:45
+  { { 6, -4 }, { 37, 41 }, { 37, 53 }, { 26, 49 }, { -6, 4 } }, // 4:50
+  { { 6, -4 }, { 35, 43 }, { 35, 55 }, { 24, 50 }, { -6, 4 } }, // 4:55
+  { { 6, -4 }, { 34, 44 }, { 33, 56 }, { 21, 51 }, { -6, 4 } }, // 5:00
+  { { 6, -3 }, { 32, 46 }, { 30, 58 }, { 19, 52 }, { -6, 3 } }, // 5:05
+  { { 6, -3 }, { 30, 47 }, { 27, 59 }, { 17, 53 }, { -6, 3 } }, // 5:10
+  { { 6, -3 }, { 28, 48 }, { 25, 60 }, { 15, 53 }, { -6, 3 } }, // 5:15
+  { { 7, -2 }, { 25, 49 }, { 22, 61 }, { 12, 54 }, { -7, 2 } }, // 5:20
+  { { 7, -2 }, { 23, 50 }, { 20, 62 }, { 10, 55 }, { -7, 2 } }, // 5:25
+  { { 7, -2 }, { 21, 51 }, { 17, 63 }, { 7, 55 }, { -7, 2 } }, // 5:30
+  { { 7, -2 }, { 19, 52 }, { 14, 63 }, { 5, 55 }, { -7, 2 } }, // 5:35
+  { { 7, -1 }, { 16, 53 }, { 11, 64 }, { 3, 55 }, { -7, 1 } }, // 5:40
+  { { 7, -1 }, { 14, 54 }, { 8, 64 }, { 0, 55 }, { -7, 1 } }, // 5:45
+  { { 7, -1 }, { 12, 54 }, { 6, 65 }, { -2, 55 }, { -7, 1 } }, // 5:50
+  { { 7, 0 }, { 9, 55 }, { 3, 65 }, { -5, 55 }, { -7, 0 } }, // 5:55
+  { { 7, 0 }, { 7, 55 }, { 0, 65 }, { -7, 55 }, { -7, 0 } }, // 6:00
+  { { 7, 0 }, { 5, 55 }, { -3, 65 }, { -9, 55 }, { -7, 0 } }, // 6:05
+  { { 7, 1 }, { 2, 55 }, { -6, 65 }, { -12, 54 }, { -7, -1 } }, // 6:10
+  { { 7, 1 }, { 0, 55 }, { -8, 64 }, { -14, 54 }, { -7, -1 } }, // 6:15
+  { { 7, 1 }, { -3, 55 }, { -11, 64 }, { -16, 53 }, { -7, -1 } }, // 6:20
+  { { 7, 2 }, { -5, 55 }, { -14, 63 }, { -19, 52 }, { -7, -2 } }, // 6:25
+  { { 7, 2 }, { -7, 55 }, { -17, 63 }, { -21, 51 }, { -7, -2 } }, // 6:30
+  { { 7, 2 }, { -10, 55 }, { -20, 62 }, { -23, 50 }, { -7, -2 } }, // 6:35
+  { { 7, 2 }, { -12, 54 }, { -22, 61 }, { -25, 49 }, { -7, -2 } }, // 6:40
+  { { 6, 3 }, { -15, 53 }, { -25, 60 }, { -28, 48 }, { -6, -3 } }, // 6:45
+  { { 6, 3 }, { -17, 53 }, { -27, 59 }, { -30, 47 }, { -6, -3 } }, // 6:50
+  { { 6, 3 }, { -19, 52 }, { -30, 58 }, { -32, 46 }, { -6, -3 } }, // 6:55
+  { { 6, 3 }, { -21, 51 }, { -32, 56 }, { -34, 44 }, { -6, -3 } }, // 7:00
+  { { 6, 4 }, { -24, 50 }, { -35, 55 }, { -35, 43 }, { -6, -4 } }, // 7:05
+  { { 6, 4 }, { -26, 49 }, { -37, 53 }, { -37, 41 }, { -6, -4 } }, // 7:10
+  { { 6, 4 }, { -28, 48 }, { -40, 52 }, { -39, 39 }, { -6, -4 } }, // 7:15
+  { { 5, 4 }, { -30, 47 }, { -42, 50 }, { -41, 38 }, { -5, -4 } }, // 7:20
+  { { 5, 5 }, { -32, 45 }, { -44, 48 }, { -42, 36 }, { -5, -5 } }, // 7:25
+  { { 5, 5 }, { -34, 44 }, { -46, 46 }, { -44, 34 }, { -5, -5 } }, // 7:30
+  { { 5, 5 }, { -36, 42 }, { -48, 44 }, { -45, 32 }, { -5, -5 } }, // 7:35
+  { { 4, 5 }, { -38, 41 }, { -50, 42 }, { -47, 30 }, { -4, -5 } }, // 7:40
+  { { 4, 6 }, { -39, 39 }, { -52, 40 }, { -48, 28 }, { -4, -6 } }, // 7:45
+  { { 4, 6 }, { -41, 37 }, { -53, 37 }, { -49, 26 }, { -4, -6 } }, // 7:50
+  { { 4, 6 }, { -43, 35 }, { -55, 35 }, { -50, 24 }, { -4, -6 } }, // 7:55
+  { { 4, 6 }, { -44, 34 }, { -56, 33 }, { -51, 21 }, { -4, -6 } }, // 8:00
+  { { 3, 6 }, { -46, 32 }, { -58, 30 }, { -52, 19 }, { -3, -6 } }, // 8:05
+  { { 3, 6 }, { -47, 30 }, { -59, 27 }, { -53, 17 }, { -3, -6 } }, // 8:10
+  { { 3, 6 }, { -48, 28 }, { -60, 25 }, { -53, 15 }, { -3, -6 } }, // 8:15
+  { { 2, 7 }, { -49, 25 }, { -61, 22 }, { -54, 12 }, { -2, -7 } }, // 8:20
+  { { 2, 7 }, { -50, 23 }, { -62, 20 }, { -55, 10 }, { -2, -7 } }, // 8:25
+  { { 2, 7 }, { -51, 21 }, { -63, 17 }, { -55, 7 }, { -2, -7 } }, // 8:30
+  { { 2, 7 }, { -52, 19 }, { -63, 14 }, { -55, 5 }, { -2, -7 } }, // 8:35
+  { { 1, 7 }, { -53, 16 }, { -64, 11 }, { -55, 3 }, { -1, -7 } }, // 8:40
+  { { 1, 7 }, { -54, 14 }, { -64, 8 }, { -55, 0 }, { -1, -7 } }, // 8:45
+  { { 1, 7 }, { -54, 12 }, { -65, 6 }, { -55, -2 }, { -1, -7 } }, // 8:50
+  { { 0, 7 }, { -55, 9 }, { -65, 3 }, { -55, -5 }, { 0, -7 } }, // 8:55
+  { { 0, 7 }, { -55, 7 }, { -65, 0 }, { -55, -7 }, { 0, -7 } }, // 9:00
+  { { 0, 7 }, { -55, 5 }, { -65, -3 }, { -55, -9 }, { 0, -7 } }, // 9:05
+  { { -1, 7 }, { -55, 2 }, { -65, -6 }, { -54, -12 }, { 1, -7 } }, // 9:10
+  { { -1, 7 }, { -55, 0 }, { -64, -8 }, { -54, -14 }, { 1, -7 } }, // 9:15
+  { { -1, 7 }, { -55, -3 }, { -64, -11 }, { -53, -16 }, { 1, -7 } }, // 9:20
+  { { -2, 7 }, { -55, -5 }, { -63, -14 }, { -52, -19 }, { 2, -7 } }, // 9:25
+  { { -2, 7 }, { -55, -7 }, { -63, -17 }, { -51, -21 }, { 2, -7 } }, // 9:30
+  { { -2, 7 }, { -55, -10 }, { -62, -20 }, { -50, -23 }, { 2, -7 } }, // 9:35
+  { { -2, 7 }, { -54, -12 }, { -61, -22 }, { -49, -25 }, { 2, -7 } }, // 9:40
+  { { -3, 6 }, { -53, -15 }, { -60, -25 }, { -48, -28 }, { 3, -6 } }, // 9:45
+  { { -3, 6 }, { -53, -17 }, { -59, -27 }, { -47, -30 }, { 3, -6 } }, // 9:50
+  { { -3, 6 }, { -52, -19 }, { -58, -30 }, { -46, -32 }, { 3, -6 } }, // 9:55
+  { { -3, 6 }, { -51, -21 }, { -56, -32 }, { -44, -34 }, { 3, -6 } }, // 10:00
+  { { -4, 6 }, { -50, -24 }, { -55, -35 }, { -43, -35 }, { 4, -6 } }, // 10:05
+  { { -4, 6 }, { -49, -26 }, { -53, -37 }, { -41, -37 }, { 4, -6 } }, // 10:10
+  { { -4, 6 }, { -48, -28 }, { -52, -40 }, { -39, -39 }, { 4, -6 } }, // 10:15
+  { { -4, 5 }, { -47, -30 }, { -50, -42 }, { -38, -41 }, { 4, -5 } }, // 10:20
+  { { -5, 5 }, { -45, -32 }, { -48, -44 }, { -36, -42 }, { 5, -5 } }, // 10:25
+  { { -5, 5 }, { -44, -34 }, { -46, -46 }, { -34, -44 }, { 5, -5 } }, // 10:30
+  { { -5, 5 }, { -42, -36 }, { -44, -48 }, { -32, -45 }, { 5, -5 } }, // 10:35
+  { { -5, 4 }, { -41, -38 }, { -42, -50 }, { -30, -47 }, { 5, -4 } }, // 10:40
+  { { -6, 4 }, { -39, -39 }, { -40, -52 }, { -28, -48 }, { 6, -4 } }, // 10:45
+  { { -6, 4 }, { -37, -41 }, { -37, -53 }, { -26, -49 }, { 6, -4 } }, // 10:50
+  { { -6, 4 }, { -35, -43 }, { -35, -55 }, { -24, -50 }, { 6, -4 } }, // 10:55
+  { { -6, 4 }, { -34, -44 }, { -33, -56 }, { -21, -51 }, { 6, -4 } }, // 11:00
+  { { -6, 3 }, { -32, -46 }, { -30, -58 }, { -19, -52 }, { 6, -3 } }, // 11:05
+  { { -6, 3 }, { -30, -47 }, { -27, -59 }, { -17, -53 }, { 6, -3 } }, // 11:10
+  { { -6, 3 }, { -28, -48 }, { -25, -60 }, { -15, -53 }, { 6, -3 } }, // 11:15
+  { { -7, 2 }, { -25, -49 }, { -22, -61 }, { -12, -54 }, { 7, -2 } }, // 11:20
+  { { -7, 2 }, { -23, -50 }, { -20, -62 }, { -10, -55 }, { 7, -2 } }, // 11:25
+  { { -7, 2 }, { -21, -51 }, { -17, -63 }, { -7, -55 }, { 7, -2 } }, // 11:30
+  { { -7, 2 }, { -19, -52 }, { -14, -63 }, { -5, -55 }, { 7, -2 } }, // 11:35
+  { { -7, 1 }, { -16, -53 }, { -11, -64 }, { -3, -55 }, { 7, -1 } }, // 11:40
+  { { -7, 1 }, { -14, -54 }, { -8, -64 }, { 0, -55 }, { 7, -1 } }, // 11:45
+  { { -7, 1 }, { -12, -54 }, { -6, -65 }, { 2, -55 }, { 7, -1 } }, // 11:50
+  { { -7, 0 }, { -9, -55 }, { -3, -65 }, { 5, -55 }, { 7, 0 } }, // 11:55
+};
+
+static const int8_t SECOND_HAND_POSE[SECOND_HAND_POSES][2] = {
+  { 0, -84 }, // 0
+  { 9, -84 }, // 1
+  { 17, -82 }, // 2
+  { 26, -80 }, // 3
+  { 34, -77 }, // 4
+  { 42, -73 }, // 5
+  { 49, -68 }, // 6
+  { 56, -62 }, // 7
+  { 62, -56 }, // 8
+  { 68, -49 }, // 9
+  { 73, -42 }, // 10
+  { 77, -34 }, // 11
+  { 80, -26 }, // 12
+  { 82, -17 }, // 13
+  { 84, -9 }, // 14
+  { 84, 0 }, // 15
+  { 84, 9 }, // 16
+  { 82, 17 }, // 17
+  { 80, 26 }, // 18
+  { 77, 34 }, // 19
+  { 73, 42 }, // 20
+  { 68, 49 }, // 21
+  { 62, 56 }, // 22
+  { 56, 62 }, // 23
+  { 49, 68 }, // 24
+  { 42, 73 }, // 25
+  { 34, 77 }, // 26
+  { 26, 80 }, // 27
+  { 17, 82 }, // 28
+  { 9, 84 }, // 29
+  { 0, 84 }, // 30
+  { -9, 84 }, // 31
+  { -17, 82 }, // 32
+  { -26, 80 }, // 33
+  { -34, 77 }, // 34
+  { -42, 73 }, // 35
+  { -49, 68 }, // 36
+  { -56, 62 }, // 37
+  { -62, 56 }, // 38
+  { -68, 49 }, // 39
+  { -73, 42 }, // 40
+  { -77, 34 }, // 41
+  { -80, 26 }, // 42
+  { -82, 17 }, // 43
+  { -84, 9 }, // 44
+  { -84, 0 }, // 45
+  { -84, -9 }, // 46
+  { -82, -17 }, // 47
+  { -80, -26 }, // 48
+  { -77, -34 }, // 49
+  { -73, -42 }, // 50
+  { -68, -49 }, // 51
+  { -62, -56 }, // 52
+  { -56, -62 }, // 53
+  { -49, -68 }, // 54
+  { -42, -73 }, // 55
+  { -34, -77 }, // 56
+  { -26, -80 }, // 57
+  { -17, -82 }, // 58
+  { -9, -84 }, // 59
+};
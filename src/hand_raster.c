@@ -0,0 +1,370 @@
+//======================================
+// TECHRAD hand rasterizer
+// Pixel centers sit on integer coordinates. Every row is filled between
+// even-odd pairs of edge crossings at the row's center, the outline is each
+// edge's x range within the row's half pixel band, drawn over the fill.
+// x values are fixed point with 8 fraction bits.
+//======================================
+
+#include "hand_raster.h"
+
+#define FIX_SHIFT 8
+#define FIX_HALF (1 << (FIX_SHIFT - 1))
+
+typedef struct RasterTarget {
+    uint8_t *data;
+    uint16_t stride;
+    int16_t width, height;
+} RasterTarget;
+
+// x ranges written to one row, a fill span or an edge's stroke
+typedef struct RasterSpan {
+    int16_t x0, x1;
+} RasterSpan;
+
+
+//======================================
+// PIXELS
+//======================================
+#ifdef PBL_COLOR
+#define RASTER_FORMAT GBitmapFormat8Bit
+#define RASTER_ROW_BYTES(w) (w)
+#else
+#define RASTER_FORMAT GBitmapFormat1Bit
+#define RASTER_ROW_BYTES(w) (((w) + 7) / 8)
+#endif
+
+bool hand_raster_supported(const GBitmap *fb) {
+    if (!fb || (gbitmap_get_format(fb) != RASTER_FORMAT)) {
+        return false;
+    }
+    GRect bounds = gbitmap_get_bounds(fb);
+    return (bounds.origin.x == 0) && (bounds.origin.y == 0) && (bounds.size.h <= HAND_RASTER_MAX_ROWS) &&
+           (gbitmap_get_bytes_per_row(fb) >= RASTER_ROW_BYTES(bounds.size.w));
+}
+
+static bool raster_target(const GBitmap *fb, RasterTarget *target) {
+    if (!hand_raster_supported(fb)) {
+        return false;
+    }
+    GSize size = gbitmap_get_bounds(fb).size;
+    target->data = gbitmap_get_data(fb);
+    target->stride = gbitmap_get_bytes_per_row(fb);
+    target->width = size.w;
+    target->height = size.h;
+    return true;
+}
+
+static bool color_visible(GColor color) {
+    return (color.argb & 0xC0) != 0; // any alpha
+}
+
+#ifndef PBL_COLOR
+// 1 bit frame buffer pixels are white when every channel is at least half
+static bool color_white(GColor color) {
+    return ((color.argb & 0x30) >= 0x20) && ((color.argb & 0x0C) >= 0x08) && ((color.argb & 0x03) >= 0x02);
+}
+
+// bits are pixels from the least significant end, whole bytes in the middle
+// value holds the new bits, from a solid color or a source row
+static void row_bits(uint8_t *row, const uint8_t *value, bool solid, int16_t x0, int16_t x1) {
+    int16_t first = x0 / 8, last = x1 / 8;
+    uint8_t first_mask = 0xFF << (x0 % 8), last_mask = 0xFF >> (7 - x1 % 8);
+    if (first == last) {
+        first_mask &= last_mask;
+    }
+    row[first] = (row[first] & ~first_mask) | (value[solid ? 0 : first] & first_mask);
+    if (first == last) {
+        return;
+    }
+    if (solid) {
+        memset(row + first + 1, value[0], last - first - 1);
+    }
+    else {
+        memcpy(row + first + 1, value + first + 1, last - first - 1);
+    }
+    row[last] = (row[last] & ~last_mask) | (value[solid ? 0 : last] & last_mask);
+}
+#endif
+
+// limit x0 to x1 of row y to the frame buffer, false if nothing is left
+static bool raster_clip(const RasterTarget *target, int16_t y, int16_t *x0, int16_t *x1) {
+    if ((y < 0) || (y >= target->height)) {
+        return false;
+    }
+    *x0 = (*x0 < 0) ? 0 : *x0;
+    *x1 = (*x1 >= target->width) ? target->width - 1 : *x1;
+    return *x0 <= *x1;
+}
+
+// x0 to x1 inclusive of row y
+static uint32_t raster_span(const RasterTarget *target, int16_t y, int16_t x0, int16_t x1, GColor color) {
+    if (!raster_clip(target, y, &x0, &x1)) {
+        return 0;
+    }
+    uint8_t *row = target->data + y * target->stride;
+    #ifdef PBL_COLOR
+    memset(row + x0, color.argb, x1 - x0 + 1);
+    #else
+    uint8_t value = color_white(color) ? 0xFF : 0x00;
+    row_bits(row, &value, true, x0, x1);
+    #endif
+    return x1 - x0 + 1;
+}
+
+// span limited to the row's range in clip
+static uint32_t raster_span_clipped(const RasterTarget *target, int16_t y, int16_t x0, int16_t x1, GColor color,
+                                    const HandRasterRows *clip) {
+    if (clip) {
+        int16_t row = y - clip->top;
+        if ((row < 0) || (row >= clip->count)) {
+            return 0;
+        }
+        x0 = (clip->x0[row] > x0) ? clip->x0[row] : x0;
+        x1 = (clip->x1[row] < x1) ? clip->x1[row] : x1;
+    }
+    return raster_span(target, y, x0, x1, color);
+}
+
+
+//======================================
+// POLYGON
+//======================================
+// x where the edge from a to b crosses the height y2 / 2, fixed point
+static int32_t edge_x(GPoint a, GPoint b, int32_t y2) {
+    return ((int32_t)a.x << FIX_SHIFT) + (((y2 - 2 * a.y) * (b.x - a.x)) << FIX_SHIFT) / (2 * (b.y - a.y));
+}
+
+static int16_t fix_round(int32_t x) {
+    return (x + FIX_HALF) >> FIX_SHIFT;
+}
+
+static int16_t fix_ceil(int32_t x) {
+    return (x + (1 << FIX_SHIFT) - 1) >> FIX_SHIFT;
+}
+
+uint32_t hand_raster_polygon(GBitmap *fb, GPoint origin, const int8_t (*points)[2], uint8_t count,
+                             GColor fill, GColor stroke, const HandRasterRows *clip) {
+    RasterTarget target;
+    GPoint p[HAND_RASTER_MAX_POINTS];
+    int16_t top, bottom;
+    uint32_t pixels = 0;
+    if ((count < 3) || (count > HAND_RASTER_MAX_POINTS) || !raster_target(fb, &target)) {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < count; ++i) {
+        p[i] = GPoint(origin.x + points[i][0], origin.y + points[i][1]);
+    }
+    top = bottom = p[0].y;
+    for (uint8_t i = 1; i < count; ++i) {
+        top = (p[i].y < top) ? p[i].y : top;
+        bottom = (p[i].y > bottom) ? p[i].y : bottom;
+    }
+    if (clip) {
+        top = (clip->top > top) ? clip->top : top;
+        bottom = (clip->top + clip->count - 1 < bottom) ? clip->top + clip->count - 1 : bottom;
+    }
+    top = (top < 0) ? 0 : top;
+    bottom = (bottom >= target.height) ? target.height - 1 : bottom;
+
+    for (int16_t y = top; y <= bottom; ++y) {
+        int32_t crossings[HAND_RASTER_MAX_POINTS];
+        RasterSpan strokes[HAND_RASTER_MAX_POINTS];
+        uint8_t crossing_count = 0, stroke_count = 0;
+
+        for (uint8_t i = 0; i < count; ++i) {
+            GPoint a = p[i], b = p[(i + 1) % count];
+            if (a.y > b.y) {
+                GPoint swap = a;
+                a = b;
+                b = swap;
+            }
+            if ((y < a.y) || (y > b.y)) {
+                continue;
+            }
+
+            // fill: half open in y so shared vertices count once
+            if (y < b.y) {
+                int32_t x = edge_x(a, b, 2 * y);
+                uint8_t j = crossing_count++;
+                while ((j > 0) && (crossings[j - 1] > x)) {
+                    crossings[j] = crossings[j - 1];
+                    j--;
+                }
+                crossings[j] = x;
+            }
+
+            // stroke: one pixel per row for steep edges, like a line would be drawn,
+            // shallow edges take the pixels whose centers are within half a row
+            RasterSpan span;
+            if (a.y == b.y) {
+                span = (RasterSpan){ (a.x < b.x) ? a.x : b.x, (a.x < b.x) ? b.x : a.x };
+            }
+            else if (abs(b.x - a.x) <= b.y - a.y) {
+                span.x0 = span.x1 = fix_round(edge_x(a, b, 2 * y));
+            }
+            else {
+                int32_t x0 = edge_x(a, b, (y == a.y) ? 2 * y : 2 * y - 1);
+                int32_t x1 = edge_x(a, b, (y == b.y) ? 2 * y : 2 * y + 1);
+                if (x0 > x1) {
+                    int32_t swap = x0;
+                    x0 = x1;
+                    x1 = swap;
+                }
+                span.x0 = fix_ceil(x0);
+                span.x1 = fix_ceil(x1) - 1;
+                // the end points themselves are always on the line
+                int16_t vertex = (y == a.y) ? a.x : (y == b.y) ? b.x : span.x0;
+                span.x0 = (vertex < span.x0) ? vertex : span.x0;
+                span.x1 = (vertex > span.x1) ? vertex : span.x1;
+            }
+            strokes[stroke_count++] = span;
+        }
+
+        if (color_visible(fill)) {
+            for (uint8_t i = 0; i + 1 < crossing_count; i += 2) {
+                pixels += raster_span_clipped(&target, y, fix_ceil(crossings[i]), crossings[i + 1] >> FIX_SHIFT, fill, clip);
+            }
+        }
+        if (color_visible(stroke)) {
+            for (uint8_t i = 0; i < stroke_count; ++i) {
+                pixels += raster_span_clipped(&target, y, strokes[i].x0, strokes[i].x1, stroke, clip);
+            }
+        }
+    }
+    return pixels;
+}
+
+
+//======================================
+// ROWS
+//======================================
+// add x to row y, rows grow downwards from the first pixel
+static void rows_add(HandRasterRows *rows, int16_t y, int16_t x0, int16_t x1) {
+    if (rows->count == 0) {
+        rows->top = y;
+    }
+    int16_t row = y - rows->top;
+    if ((row < 0) || (row >= HAND_RASTER_MAX_ROWS)) {
+        return;
+    }
+    while (rows->count <= row) {
+        rows->x0[rows->count] = INT16_MAX;
+        rows->x1[rows->count] = INT16_MIN;
+        rows->count++;
+    }
+    rows->x0[row] = (x0 < rows->x0[row]) ? x0 : rows->x0[row];
+    rows->x1[row] = (x1 > rows->x1[row]) ? x1 : rows->x1[row];
+}
+
+// Bresenham, a second pixel across the main direction for width 2
+// drawn from the top so the rows only ever grow downwards
+void hand_raster_line_rows(GPoint a, GPoint b, uint8_t width, HandRasterRows *rows) {
+    rows->count = 0;
+    if (a.y > b.y) {
+        GPoint swap = a;
+        a = b;
+        b = swap;
+    }
+
+    int16_t dx = (b.x > a.x) ? b.x - a.x : a.x - b.x, sx = (a.x < b.x) ? 1 : -1;
+    int16_t dy = b.y - a.y;
+    bool steep = dy > dx;
+    int16_t error = dx - dy;
+    for (;;) {
+        if (steep) {
+            rows_add(rows, a.y, a.x, a.x + width - 1);
+        }
+        else {
+            rows_add(rows, a.y, a.x, a.x);
+            if (width > 1) {
+                rows_add(rows, a.y + 1, a.x, a.x);
+            }
+        }
+        if ((a.x == b.x) && (a.y == b.y)) {
+            break;
+        }
+        int16_t error2 = 2 * error;
+        if (error2 > -dy) {
+            error -= dy;
+            a.x += sx;
+        }
+        if (error2 < dx) {
+            error += dx;
+            a.y += 1;
+        }
+    }
+}
+
+void hand_raster_rows_rect(GRect rect, HandRasterRows *rows) {
+    rows->count = 0;
+    for (int16_t y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+        rows_add(rows, y, rect.origin.x, rect.origin.x + rect.size.w - 1);
+    }
+}
+
+void hand_raster_rows_exclude(HandRasterRows *rows, GRect rect) {
+    int16_t left = rect.origin.x, right = rect.origin.x + rect.size.w - 1;
+    for (int16_t row = 0; row < rows->count; ++row) {
+        int16_t y = rows->top + row;
+        if ((y < rect.origin.y) || (y >= rect.origin.y + rect.size.h)) {
+            continue;
+        }
+        if ((rows->x0[row] >= left) && (rows->x0[row] <= right)) {
+            rows->x0[row] = right + 1;
+        }
+        if ((rows->x1[row] >= left) && (rows->x1[row] <= right)) {
+            rows->x1[row] = left - 1;
+        }
+    }
+}
+
+bool hand_raster_rows_touch(const HandRasterRows *rows, GRect rect) {
+    int16_t left = rect.origin.x, right = rect.origin.x + rect.size.w - 1;
+    for (int16_t row = 0; row < rows->count; ++row) {
+        int16_t y = rows->top + row;
+        if ((y < rect.origin.y) || (y >= rect.origin.y + rect.size.h) || (rows->x1[row] < rows->x0[row])) {
+            continue;
+        }
+        if ((rows->x0[row] <= right) && (rows->x1[row] >= left)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t hand_raster_fill_rows(GBitmap *fb, const HandRasterRows *rows, GColor color) {
+    RasterTarget target;
+    uint32_t pixels = 0;
+    if (!color_visible(color) || !raster_target(fb, &target)) {
+        return 0;
+    }
+    for (int16_t row = 0; row < rows->count; ++row) {
+        pixels += raster_span(&target, rows->top + row, rows->x0[row], rows->x1[row], color);
+    }
+    return pixels;
+}
+
+uint32_t hand_raster_copy_rows(GBitmap *fb, const GBitmap *source, const HandRasterRows *rows) {
+    RasterTarget target, from;
+    uint32_t pixels = 0;
+    if (!raster_target(fb, &target) || !raster_target(source, &from)) {
+        return 0;
+    }
+    for (int16_t row = 0; row < rows->count; ++row) {
+        int16_t y = rows->top + row, x0 = rows->x0[row], x1 = rows->x1[row];
+        if ((y >= from.height) || !raster_clip(&target, y, &x0, &x1)) {
+            continue;
+        }
+        uint8_t *to_row = target.data + y * target.stride;
+        const uint8_t *from_row = from.data + y * from.stride;
+        #ifdef PBL_COLOR
+        memcpy(to_row + x0, from_row + x0, x1 - x0 + 1);
+        #else
+        row_bits(to_row, from_row, false, x0, x1);
+        #endif
+        pixels += x1 - x0 + 1;
+    }
+    return pixels;
+}
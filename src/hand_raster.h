@@ -0,0 +1,52 @@
+//======================================
+// TECHRAD hand rasterizer
+// Fills and outlines the hand polygons straight into a captured
+// frame buffer, one pass over the rows, instead of GPath fill + outline
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+#define HAND_RASTER_MAX_POINTS 10 // most points of any hand polygon
+#define HAND_RASTER_MAX_ROWS 168  // tallest frame buffer drawn into, aplite and basalt
+
+// one x range per row, rows top to top + count - 1, x1 < x0 leaves a row empty
+// describes the pixels of a line, or limits what a polygon may touch
+typedef struct HandRasterRows {
+    int16_t top;
+    int16_t count;
+    int16_t x0[HAND_RASTER_MAX_ROWS];
+    int16_t x1[HAND_RASTER_MAX_ROWS];
+} HandRasterRows;
+
+// true if fb has the row layout this build writes, 1 bit on black and white platforms,
+// 8 bit on color ones, a rectangle of at most HAND_RASTER_MAX_ROWS rows
+// other frame buffers, round or 8 bit on a black and white build, need GPath instead
+bool hand_raster_supported(const GBitmap *fb);
+
+// all drawing functions return the number of pixels written, 0 if fb isn't supported
+
+// polygon of count points, offsets from origin, filled with the even-odd rule
+// and outlined along every edge in the same pass, GColorClear skips either part
+// only pixels inside clip are written, NULL for no limit
+uint32_t hand_raster_polygon(GBitmap *fb, GPoint origin, const int8_t (*points)[2], uint8_t count,
+                             GColor fill, GColor stroke, const HandRasterRows *clip);
+
+// pixels of a straight line from a to b, 1 or 2 pixels wide
+void hand_raster_line_rows(GPoint a, GPoint b, uint8_t width, HandRasterRows *rows);
+
+// every pixel of rect, rows below HAND_RASTER_MAX_ROWS from its top are left out
+void hand_raster_rows_rect(GRect rect, HandRasterRows *rows);
+
+// take the pixels inside rect out of rows, rows must not pass through it from both sides
+void hand_raster_rows_exclude(HandRasterRows *rows, GRect rect);
+
+// true if any pixel of rows lies inside rect
+bool hand_raster_rows_touch(const HandRasterRows *rows, GRect rect);
+
+// fill every row range with color
+uint32_t hand_raster_fill_rows(GBitmap *fb, const HandRasterRows *rows, GColor color);
+
+// copy every row range from source, a bitmap of the frame buffer's size and format
+uint32_t hand_raster_copy_rows(GBitmap *fb, const GBitmap *source, const HandRasterRows *rows);
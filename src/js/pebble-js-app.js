@@ -1,11 +1,9 @@
 // TECHRAD JS
 
-var config={}; // CONFIG_SECONDS, CONFIG_HOURVIBES, CONFIG_FAHRENHEIT, CONFIG_24H, CONFIG_SETCITY, CONFIG_CITYID
-var locationOptions = { "timeout": 72000, "maximumAge": 2000000 };
+var config={}; // CONFIG_SECONDS, CONFIG_HOURVIBES, CONFIG_FAHRENHEIT, CONFIG_SETCITY, CONFIG_CITYID
 var prevcity = ""; // previous city if set
 //var appid = "869c6da7ab3f807c4b15fd7574786e72"; // Openweathermap API ID
 var appid = "d204cb99d4331fffa26340b8e03bbe17"; // Openweathermap API ID
-var newForecastLoaded = false;
 
 //======================================
 // GET ICON FROM WEATHER ID
@@ -76,190 +74,690 @@ function tempConverter(intemp) {
 }
 
 //======================================
-// WINDSPEED CONVERTER - meters per second to km/h or mph
+// WINDSPEED VALUE - meters per second to whole km/h or mph
 // depends on Fahrenheit/metric config setting
 //======================================
-function windConverter(inwind) {
-	if (config.CONFIG_FAHRENHEIT == 1) {		  
-		return Math.round(((inwind * 60 * 60)/1000)*0.6214) + " mph"; // return mph
+function windValue(inwind) {
+	if (config.CONFIG_FAHRENHEIT == 1) {
+		return Math.round(((inwind * 60 * 60)/1000)*0.6214); // mph
 	}
 	else {
-		return Math.round((inwind * 60 * 60)/1000) + " km/h"; // return km/h	
+		return Math.round((inwind * 60 * 60)/1000); // km/h
 	}
 }
 
 //======================================
-// FETCH CURRENT WEATHER DATA
+// PACK WEATHER - compact binary record for the watch
+// layout must match WeatherRecord in techrad.c, multi byte values are little endian
 //======================================
-function fetchWeather(favcity, latitude, longitude) {
-//    newForecastLoaded = false;
-    
-	// save location data for cache
-	if (latitude != null) {
-		localStorage.setItem("latitude", latitude);
+var WEATHER_RECORD_VERSION = 2;
+var WEATHER_FLAG_IMPERIAL = 0x1; // Fahrenheit and mph
+var WEATHER_FLAG_NO_DATA = 0x4;  // no temperatures, wind or sun times
+var WEATHER_FLAG_NO_GPS = 0x8;   // location failed
+var WEATHER_CITY_MAX = 19;       // bytes of city name
+var WEATHER_NO_LOCATION = -32768; // latitude when the position is unknown
+
+// UTF-8 bytes of a string, cut to max bytes without splitting a character
+function utf8Bytes(text, max) {
+	var encoded = unescape(encodeURIComponent(text || ""));
+	var bytes = [];
+	for (var i = 0; i < encoded.length && i < max; i++) {
+		bytes.push(encoded.charCodeAt(i));
 	}
-	if (longitude != null) {
-		localStorage.setItem("longitude", longitude);
+	if (encoded.length > max) {
+		while (bytes.length > 0 && (bytes[bytes.length - 1] & 0xC0) == 0x80) {
+			bytes.pop(); // continuation byte of a cut character
+		}
+		if (bytes.length > 0 && bytes[bytes.length - 1] >= 0xC0) {
+			bytes.pop(); // lead byte of a cut character
+		}
 	}
+	return bytes;
+}
 
-    // load weather data based on city name, city id, gps
-	var req = new XMLHttpRequest();
-	if (favcity != null) {
-        if (config.CONFIG_CITYID == 0) {
-            console.log("fetching city name");
-            req.open('GET', "http://api.openweathermap.org/data/2.5/weather?" +
-                     "q=" + favcity + "&cnt=1&APPID=" + appid, true);
-        }
-        else {
-            console.log("fetching city id");
-            req.open('GET', "http://api.openweathermap.org/data/2.5/weather?" +
-                     "id=" + favcity + "&cnt=1&APPID=" + appid, true);
-        }
-    }
-    else {
-        console.log("fetching gps");
-		req.open('GET', "http://api.openweathermap.org/data/2.5/weather?" +
-                 "lat=" + latitude + "&lon=" + longitude + "&cnt=1&APPID=" + appid, true);
+function clampByte(value, min, max) {
+	value = Math.round(Number(value) || 0);
+	return Math.max(min, Math.min(max, value));
+}
+
+function packWeather(w) {
+	var bytes = [
+		WEATHER_RECORD_VERSION,
+		w.icon,
+		w.forecast_icon,
+		w.flags,
+		clampByte(w.temperature, -128, 127) & 0xFF,
+		clampByte(w.min_temp, -128, 127) & 0xFF,
+		clampByte(w.max_temp, -128, 127) & 0xFF,
+		clampByte(w.wind, 0, 255)
+	];
+	// the watch works out sunrise and sunset from the position, in hundredths of a degree
+	var known = (w.latitude != null) && (w.longitude != null);
+	[known ? Math.round(w.latitude * 100) : WEATHER_NO_LOCATION, known ? Math.round(w.longitude * 100) : 0].forEach(function (value) {
+		bytes.push(value & 0xFF, (value >> 8) & 0xFF);
+	});
+	var city = utf8Bytes(w.city, WEATHER_CITY_MAX);
+	bytes.push(city.length);
+	return bytes.concat(city);
+}
+
+// forecast slots for the watch to step through offline, see WeatherTimeline in techrad.c
+// version, flags, minutes per slot, slot count, start epoch, then icon, temperature, wind per slot
+var WEATHER_TIMELINE_VERSION = 1;
+var WEATHER_TIMELINE_SLOTS = 16; // 48 hours of 3 hour steps
+
+function packTimeline(slots, flags) {
+	if (!slots || slots.length < 2) {
+		return null;
 	}
-//	req.onload = function (e) {
-	req.onreadystatechange = function (e) {
-		if (req.readyState == 4) {
-			if (req.status == 200) {
-//				console.log(req.responseText);
-				var response = JSON.parse(req.responseText);
-                if (response.cod == "404") {
-                    //console.log("404 no data found");
-                    localStorage.setItem("temperature", "-");
-                    localStorage.setItem("city", "no data");
-                    localStorage.setItem("icon", 4);
-                }
-                else {
-                    var temperature = response.main.temp; // in K
-                    var windspeed = response.wind.speed; // in mps
-                    var icon = iconFromWeatherId(response.weather[0].id);
-                    var city = response.name;
-                    var sunrise_UTC = response.sys.sunrise;
-                    var sunset_UTC = response.sys.sunset;
-                    var fetch_timestamp = new Date(response.dt * 1000);
-
-                    // Save weather data for cache
-                    localStorage.setItem("icon", icon);
-                    localStorage.setItem("temperature", temperature);
-                    localStorage.setItem("windspeed", windspeed);
-                    localStorage.setItem("city", city);
-                    localStorage.setItem("sunrise_time", sunrise_UTC);
-                    localStorage.setItem("sunset_time", sunset_UTC);
-                    localStorage.setItem("weather_timestamp", fetch_timestamp);
-                }
+	slots = slots.slice(0, WEATHER_TIMELINE_SLOTS);
+	var start = Math.floor(slots[0].time);
+	var bytes = [
+		WEATHER_TIMELINE_VERSION,
+		flags,
+		clampByte((slots[1].time - slots[0].time) / 60, 1, 255),
+		slots.length,
+		start & 0xFF, (start >>> 8) & 0xFF, (start >>> 16) & 0xFF, (start >>> 24) & 0xFF
+	];
+	slots.forEach(function (slot) {
+		bytes.push(slot.icon, clampByte(tempConverter(slot.temperature), -128, 127) & 0xFF, clampByte(windValue(slot.wind), 0, 255));
+	});
+	return bytes;
+}
+
+// size of the same data as the old string tuples, for comparison in the log
+// one byte dictionary header, 7 bytes per tuple header, 4 byte ints, NUL terminated strings
+function legacyMessageSize(w) {
+	var strings = [];
+	var ints = 2;
+	if (w.flags & (WEATHER_FLAG_NO_DATA | WEATHER_FLAG_NO_GPS)) {
+		strings = ["", "", "", (w.flags & WEATHER_FLAG_NO_GPS) ? "GPS" : "", w.city];
+	}
+	else {
+		var units = (w.flags & WEATHER_FLAG_IMPERIAL) ? " mph" : " km/h";
+		strings = [w.temperature + "\u00B0", w.city, timeConverter(w.sunrise) + "\n" + timeConverter(w.sunset),
+			w.min_temp + "-" + w.max_temp + "\u00B0", w.wind + units];
+	}
+	var size = 1 + (strings.length + ints) * 7 + ints * 4;
+	strings.forEach(function (s) {
+		size += unescape(encodeURIComponent(s)).length + 1;
+	});
+	return size;
+}
+
+//======================================
+// DELTA SYNC - remember what the watch already has
+// reset on ready, the watch app has just started
+//======================================
+var lastSentWeather = null;	// packed record last acknowledged by the watch
+var lastSentTimeline = null;	// packed timeline last acknowledged by the watch
+var lastSentConfig = {};	// config values last acknowledged by the watch
+var suppressedMessages = 0;	// messages not sent today
+var suppressedDay = new Date().toDateString();
+
+function resetDeltaSync() {
+	lastSentWeather = null;
+	lastSentTimeline = null;
+	lastSentConfig = {};
+}
+
+function countSuppressed(what) {
+	var today = new Date().toDateString();
+	if (today != suppressedDay) {
+		console.log(suppressedMessages + " unchanged messages suppressed on " + suppressedDay);
+		suppressedMessages = 0;
+		suppressedDay = today;
+	}
+	suppressedMessages++;
+	console.log(what + " unchanged, not sent (" + suppressedMessages + " today)");
+}
+
+//======================================
+// SEND WEATHER TO WATCH
+//======================================
+// record and timeline go in one message, each only if the watch doesn't have it yet
+// a refresh the watch asked for always gets the record, the watch shows the
+// loading icon until a record arrives, even an unchanged one
+function sendWeather(w, slots) {
+	var packed = packWeather(w);
+	var record = packed.join(",");
+	var timeline = packTimeline(slots, w.flags);
+	var timelineKey = timeline ? timeline.join(",") : null;
+	var message = {};
+	if ((record != lastSentWeather) || refreshForWatch) {
+		message.WEATHER_PACKED = packed;
+		console.log("weather message " + (1 + 7 + packed.length) + " bytes, string tuples would be " + legacyMessageSize(w) + " bytes");
+	}
+	if (timeline && (timelineKey != lastSentTimeline)) {
+		message.WEATHER_TIMELINE = timeline;
+		console.log("timeline of " + (timeline[3]) + " slots, " + (7 + timeline.length) + " bytes");
+	}
+	if (Object.keys(message).length == 0) {
+		countSuppressed("weather");
+		return;
+	}
+	Pebble.sendAppMessage(message,
+		function (e) {
+			lastSentWeather = record;
+			if (timeline) {
+				lastSentTimeline = timelineKey;
 			}
+		},
+		function (e) {
+			console.log("weather message not delivered");
+		});
+}
+
+// placeholder record when there is nothing to show
+function emptyWeather(city, flags) {
+	return { icon: 4, forecast_icon: 4, flags: flags, temperature: 0, min_temp: 0, max_temp: 0,
+		wind: 0, latitude: null, longitude: null, city: city };
+}
+
+//======================================
+// TELEMETRY - hourly frame costs from the watch
+// set to true together with TELEMETRY in telemetry.h
+// layout must match TelemetrySample in telemetry.h, little endian
+//======================================
+var TELEMETRY = false;
+var TELEMETRY_PROBES = ["bg", "hands", "date", "sync"];
+var telemetrySamples = [];
+
+function requestTelemetry() {
+	Pebble.sendAppMessage({ "TELEMETRY_REQUEST": 1 }, null,
+		function (e) {
+			console.log("telemetry request not delivered");
+		});
+}
+
+function readTelemetrySample(bytes, offset) {
+	function u16() { var v = bytes[offset] | (bytes[offset + 1] << 8); offset += 2; return v; }
+	function u32() { var v = (u16() + u16() * 65536); return v; }
+	var n = TELEMETRY_PROBES.length;
+	var s = { hour: u32(), runs: [], ms_max: [], ms_total: [] };
+	var i;
+	for (i = 0; i < n; i++) s.runs.push(u16());
+	for (i = 0; i < n; i++) s.ms_max.push(u16());
+	for (i = 0; i < n; i++) s.ms_total.push(u32());
+	s.messages_in = u16();
+	s.messages_out = u16();
+	s.persist_writes = u16();
+	s.heap_high_water = u32();
+	return s;
+}
+
+// version, index, count, sample, the summary goes out with the last one
+function receiveTelemetry(bytes) {
+	if (bytes[0] != 1) {
+		console.log("telemetry version " + bytes[0] + " not understood");
+		return;
+	}
+	var index = bytes[1], count = bytes[2];
+	if (index == 0) {
+		telemetrySamples = [];
+	}
+	var s = readTelemetrySample(bytes, 3);
+	telemetrySamples.push(s);
+	console.log("telemetry " + new Date(s.hour * 3600000).toISOString() + ": " + TELEMETRY_PROBES.map(function (name, i) {
+		return name + " " + s.runs[i] + "x avg " + (s.runs[i] ? (s.ms_total[i] / s.runs[i]).toFixed(1) : 0) + " max " + s.ms_max[i] + " ms";
+	}).join(", ") + ", in " + s.messages_in + " out " + s.messages_out + ", writes " + s.persist_writes + ", heap " + s.heap_high_water);
+	if (index + 1 < count) {
+		return;
+	}
+
+	var hours = telemetrySamples.length;
+	var total = { messages_in: 0, messages_out: 0, persist_writes: 0, heap: 0 };
+	var summary = TELEMETRY_PROBES.map(function (name, i) {
+		var runs = 0, ms = 0;
+		telemetrySamples.forEach(function (t) { runs += t.runs[i]; ms += t.ms_total[i]; });
+		return name + " " + (runs / hours).toFixed(1) + "/h avg " + (runs ? (ms / runs).toFixed(1) : 0) + " ms";
+	});
+	telemetrySamples.forEach(function (t) {
+		total.messages_in += t.messages_in;
+		total.messages_out += t.messages_out;
+		total.persist_writes += t.persist_writes;
+		total.heap = Math.max(total.heap, t.heap_high_water);
+	});
+	console.log("telemetry over " + hours + " h: " + summary.join(", ") + ", messages in " + total.messages_in +
+		" out " + total.messages_out + ", persist writes " + total.persist_writes + ", heap high water " + total.heap);
+}
+
+//======================================
+// WEATHER REFRESH - one pipeline for ready, appmessage and webviewclosed
+// a trigger while a refresh runs joins it, a config change runs once more after it
+//======================================
+var refreshRunning = false;
+var refreshTrigger = "";
+var refreshStarted = 0;
+var refreshQueued = null;	// trigger to run once the current refresh is done
+var refreshForWatch = false;	// the watch asked, started or joined the running refresh
+var refreshWatchdog = null;
+// longer than the slowest path: coarse and fine location, then both requests
+var REFRESH_WATCHDOG_MS = 3 * 60000;
+
+function refreshWeather(trigger, rerun) {
+	if (trigger == "watch") {
+		refreshForWatch = true;
+	}
+	if (refreshRunning) {
+		if (rerun) {
+			refreshQueued = trigger;
 		}
+		console.log("weather refresh from " + trigger + (rerun ? " queued after " : " joined ") + refreshTrigger);
+		return;
+	}
+	refreshRunning = true;
+	refreshTrigger = trigger;
+	refreshStarted = Date.now();
+	// a location or request callback that never comes would block every later refresh
+	refreshWatchdog = setTimeout(function () {
+		refreshWatchdog = null;
+		refreshDone("abandoned, no answer");
+	}, REFRESH_WATCHDOG_MS);
+
+	// favorite city name or city ID, else GPS location
+	if ((config.CONFIG_SETCITY) && (config.CONFIG_SETCITY != "undefined")) {
+		var key = configLocationKey();
+		if (weatherCacheAge(key) < WEATHER_MAX_AGE) {
+			countLocation("reused");
+			sendCachedWeather(key);
+			refreshDone("reused cached weather");
+			return;
+		}
+		countLocation("fetches");
+		fetchWeather(config.CONFIG_SETCITY, null, null);
+	}
+	else {
+		refreshFromLocation();
+	}
+}
+
+function refreshDone(result) {
+	if (!refreshRunning) {
+		return; // a late callback of a refresh the watchdog gave up on
+	}
+	if (refreshWatchdog) {
+		clearTimeout(refreshWatchdog);
+		refreshWatchdog = null;
+	}
+	console.log("weather refresh from " + refreshTrigger + " " + result + " in " + (Date.now() - refreshStarted) + " ms");
+	refreshRunning = false;
+	refreshForWatch = false;
+	if (refreshQueued) {
+		var trigger = refreshQueued;
+		refreshQueued = null;
+		refreshWeather(trigger, false);
+	}
+}
+
+//======================================
+// FETCH CURRENT WEATHER AND FORECAST
+// both requests run at once, the watch gets one update when both are done
+// set "weather_api_base" in localStorage to point at a stand-in server,
+// see tools/fake_openweathermap.py
+//======================================
+var WEATHER_API_BASE = "http://api.openweathermap.org/data/2.5/";
+var WEATHER_FETCH_TIMEOUT = 20000; // ms per request
+
+var weatherApiBaseOverride = null;
+
+function weatherApiBase() {
+	if (weatherApiBaseOverride == null) {
+		weatherApiBaseOverride = localStorage.getItem("weather_api_base") || "";
 	}
+	return weatherApiBaseOverride || WEATHER_API_BASE;
+}
+
+// GET and parse JSON, callback(error, response) exactly once
+function getJSON(url, callback) {
+	var req = new XMLHttpRequest();
+	var finished = false;
+	var timer = setTimeout(function () {
+		if (!finished) {
+			finished = true;
+			req.abort();
+			callback("timeout", null);
+		}
+	}, WEATHER_FETCH_TIMEOUT);
+
+	req.onreadystatechange = function (e) {
+		if ((req.readyState != 4) || finished) {
+			return;
+		}
+		finished = true;
+		clearTimeout(timer);
+		if (req.status != 200) {
+			callback("HTTP " + req.status, null);
+			return;
+		}
+		var response;
+		try {
+			response = JSON.parse(req.responseText);
+		}
+		catch (err) {
+			callback("bad JSON", null);
+			return;
+		}
+		callback(null, response);
+	};
+	req.open('GET', url, true);
 	req.send(null);
+}
 
-    // load forecast data based on city name, city id, gps
-	var reqf = new XMLHttpRequest();
+// city name, city id or gps
+function weatherQuery(favcity, latitude, longitude) {
 	if (favcity != null) {
-        if (config.CONFIG_CITYID == 0) {
-            //console.log("Forecast loading favcity");
-            reqf.open('GET', "http://api.openweathermap.org/data/2.5/forecast?" +
-                      "q=" + favcity + "&cnt=4&APPID=" + appid, true);
-        }
-        else {
-            reqf.open('GET', "http://api.openweathermap.org/data/2.5/forecast?" +
-                     "id=" + favcity + "&cnt=4&APPID=" + appid, true);
-        }
-    }
-	else {
-        //console.log("Forecast loading GPS");
-		reqf.open('GET', "http://api.openweathermap.org/data/2.5/forecast?" +
-                  "lat=" + latitude + "&lon=" + longitude + "&cnt=4&APPID=" + appid, true);
-	}
-//	reqf.onload = function (x) {
-	reqf.onreadystatechange = function (x) {
-		if (reqf.readyState == 4) {
-			if (reqf.status == 200) {
-//				console.log(reqf.responseText);
-				var responsef = JSON.parse(reqf.responseText);
-                if (responsef.cod == "404") {
-                    //console.log("Error 404 forecast");
-                    localStorage.setItem("forecast_icon", 4);
-                }
-                else {
-                    var min_temp = Math.min(responsef.list[0].main.temp_min, responsef.list[1].main.temp_min, responsef.list[2].main.temp_min, responsef.list[3].main.temp_min); // in K
-                    var max_temp = Math.max(responsef.list[0].main.temp_max, responsef.list[1].main.temp_max, responsef.list[2].main.temp_max, responsef.list[3].main.temp_max); // in K
-                    var forecast_icon = iconFromWeatherId(responsef.list[0].weather[0].id);
-
-                    // Save forecast data for cache
-                    localStorage.setItem("min_temp", min_temp);
-                    localStorage.setItem("max_temp", max_temp);
-                    localStorage.setItem("forecast_icon", forecast_icon);
-                }
-                readCachedData();
+		return ((config.CONFIG_CITYID == 0) ? "q=" : "id=") + encodeURIComponent(favcity);
+	}
+	return "lat=" + latitude + "&lon=" + longitude;
+}
+
+// cache key of a location, the same city asked for by name or id are different keys
+function locationKey(favcity) {
+	if (favcity != null) {
+		return ((config.CONFIG_CITYID == 0) ? "q:" : "id:") + favcity;
+	}
+	return "gps";
+}
+
+function configLocationKey() {
+	if ((config.CONFIG_SETCITY) && (config.CONFIG_SETCITY != "undefined")) {
+		return locationKey(config.CONFIG_SETCITY);
+	}
+	return locationKey(null);
+}
+
+// current conditions, temperatures in K and wind in mps as the API sends them
+function currentFromResponse(response) {
+	if (response.cod == "404") {
+		return { found: false, icon: 4, city: "no data" };
+	}
+	return {
+		found: true,
+		icon: iconFromWeatherId(response.weather[0].id),
+		temperature: response.main.temp,
+		windspeed: response.wind.speed,
+		city: response.name,
+		latitude: response.coord ? response.coord.lat : null,
+		longitude: response.coord ? response.coord.lon : null,
+		sunrise: response.sys.sunrise,
+		sunset: response.sys.sunset,
+		timestamp: response.dt * 1000
+	};
+}
+
+function forecastFromResponse(responsef) {
+	if (responsef.cod == "404") {
+		return { icon: 4, min_temp: null, max_temp: null, slots: [] };
+	}
+	var list = responsef.list;
+	return {
+		icon: iconFromWeatherId(list[0].weather[0].id),
+		min_temp: Math.min(list[0].main.temp_min, list[1].main.temp_min, list[2].main.temp_min, list[3].main.temp_min),
+		max_temp: Math.max(list[0].main.temp_max, list[1].main.temp_max, list[2].main.temp_max, list[3].main.temp_max),
+		slots: list.slice(0, WEATHER_TIMELINE_SLOTS).map(function (item) {
+			return { time: item.dt, icon: iconFromWeatherId(item.weather[0].id), temperature: item.main.temp, wind: item.wind ? item.wind.speed : 0 };
+		})
+	};
+}
+
+// the record only goes to the cache, and the watch, once both requests are done
+// saved is when the record was written, updated only when both requests succeeded,
+// so a half fetched record is fetched again on the next refresh instead of reused
+function fetchWeather(favcity, latitude, longitude) {
+	var key = locationKey(favcity);
+	var previous = weatherCache.locations[key] || {};
+	var record = { current: previous.current, forecast: previous.forecast };
+	if (latitude != null) {
+		record.position = { latitude: latitude, longitude: longitude }; // where this weather is for
+	}
+	var query = weatherQuery(favcity, latitude, longitude);
+	var pending = 2;
+	var failures = [];
+
+	// a 404 is a city the server doesn't know, cache that as no data
+	function stored(what, err, response, parse) {
+		if (err == "HTTP 404") {
+			response = { cod: "404" };
+			err = null;
+		}
+		if (err) {
+			failures.push(what + " " + err);
+		}
+		else {
+			try {
+				record[what] = parse(response);
+			}
+			catch (ex) {
+				failures.push(what + " unexpected response");
+			}
+		}
+		if (--pending > 0) {
+			return;
+		}
+		if (failures.length < 2) {
+			record.saved = Date.now();
+			if (!failures.length) {
+				record.updated = record.saved;
 			}
+			saveWeatherCache(key, record);
 		}
+		sendCachedWeather(key); // the one update for the watch, older values fill in failures
+		refreshDone(failures.length ? "failed (" + failures.join(", ") + ")" : "done");
 	}
-	reqf.send(null);
+
+	getJSON(weatherApiBase() + "weather?" + query + "&cnt=1&APPID=" + appid, function (err, response) {
+		stored("current", err, response, currentFromResponse);
+	});
+	getJSON(weatherApiBase() + "forecast?" + query + "&cnt=" + WEATHER_TIMELINE_SLOTS + "&APPID=" + appid, function (err, response) {
+		stored("forecast", err, response, forecastFromResponse);
+	});
 }
 
 
 //======================================
-// READ CACHED DATA FROM PHONE
+// WEATHER CACHE - one versioned record per location in a single localStorage item
+// parsed once at ready, written back whole after a refresh
 //======================================
-function readCachedData() {
+var WEATHER_CACHE_KEY = "weather_cache";
+var WEATHER_CACHE_VERSION = 1;
+var WEATHER_CACHE_LOCATIONS = 4; // most recently refreshed locations kept
+var WEATHER_CACHE_OLD_KEYS = ["icon", "temperature", "windspeed", "city", "sunrise_time", "sunset_time",
+	"weather_timestamp", "forecast_icon", "min_temp", "max_temp", "latitude", "longitude"];
+var weatherCache = { version: WEATHER_CACHE_VERSION, locations: {}, position: null };
+
+function loadWeatherCache() {
+	var cache = null;
+	try {
+		cache = JSON.parse(localStorage.getItem(WEATHER_CACHE_KEY));
+	}
+	catch (err) {
+		console.log("weather cache unreadable, starting empty");
+	}
+	if (cache && (cache.version == WEATHER_CACHE_VERSION)) {
+		weatherCache = cache;
+		return;
+	}
+	weatherCache = { version: WEATHER_CACHE_VERSION, locations: {}, position: null };
+	migrateWeatherCache();
+}
+
+// one item per value from before the cache record, kept as the configured location
+function migrateWeatherCache() {
 	if (localStorage.getItem("weather_timestamp") != null) {
-		var cached_icon = Math.floor(localStorage.getItem("icon"));
-		var cached_temperature = localStorage.getItem("temperature");
-		var cached_windspeed = localStorage.getItem("windspeed");
-		var cached_city = localStorage.getItem("city");
-		var cached_sunrise_UTC = localStorage.getItem("sunrise_time");
-		var cached_sunset_UTC = localStorage.getItem("sunset_time");
-		var cached_timestamp_time = localStorage.getItem("timestamp_time");
-		var cached_forecast_icon = Math.floor(localStorage.getItem("forecast_icon"));
-		var cached_min_temp = localStorage.getItem("min_temp");
-		var cached_max_temp = localStorage.getItem("max_temp");
-
-		// do temperature conversions
-		var temperature_formatted = tempConverter(cached_temperature);
-		var min_temp_formatted = tempConverter(cached_min_temp);
-		var max_temp_formatted = tempConverter(cached_max_temp);
-		
-		// do windspeed conversions
-		var windspeed_formatted = windConverter(cached_windspeed);
-		
-		// do time conversions from UTC to ampm/24 hour time
-		var cached_sunrise_time = timeConverter(cached_sunrise_UTC);
-		var cached_sunset_time = timeConverter(cached_sunset_UTC);
-		
-		Pebble.sendAppMessage({
-	      	"WEATHER_ICON":cached_icon,
-	      	"WEATHER_TEMPERATURE":temperature_formatted + "\u00B0",
-	      	"WEATHER_CITY":cached_city,
-		  	"WEATHER_SUNTIMES":cached_sunrise_time + "\n" + cached_sunset_time,
-		  	"WEATHER_FORECASTICON":cached_forecast_icon,
-          	"WEATHER_MINMAXTEMP": min_temp_formatted + "-" + max_temp_formatted + "\u00B0",
-			"WEATHER_MISC":windspeed_formatted,
-		});
+		var temperature = localStorage.getItem("temperature");
+		var record = {
+			updated: new Date(localStorage.getItem("weather_timestamp")).getTime() || 0,
+			current: (temperature == "-") ? { found: false, icon: 4, city: "no data" } : {
+				found: true,
+				icon: Number(localStorage.getItem("icon")),
+				temperature: Number(temperature),
+				windspeed: Number(localStorage.getItem("windspeed")),
+				city: localStorage.getItem("city"),
+				sunrise: Number(localStorage.getItem("sunrise_time")),
+				sunset: Number(localStorage.getItem("sunset_time"))
+			},
+			forecast: {
+				icon: Number(localStorage.getItem("forecast_icon")),
+				min_temp: Number(localStorage.getItem("min_temp")),
+				max_temp: Number(localStorage.getItem("max_temp"))
+			}
+		};
+		weatherCache.locations[configLocationKey()] = record;
+	}
+	if (localStorage.getItem("latitude") != null) {
+		weatherCache.position = { latitude: Number(localStorage.getItem("latitude")), longitude: Number(localStorage.getItem("longitude")), time: 0 };
+	}
+	WEATHER_CACHE_OLD_KEYS.forEach(function (key) {
+		localStorage.removeItem(key);
+	});
+	localStorage.setItem(WEATHER_CACHE_KEY, JSON.stringify(weatherCache));
+}
+
+function saveWeatherCache(key, record) {
+	weatherCache.locations[key] = record;
+	var keys = Object.keys(weatherCache.locations).sort(function (a, b) {
+		return recordSaved(weatherCache.locations[b]) - recordSaved(weatherCache.locations[a]);
+	});
+	keys.slice(WEATHER_CACHE_LOCATIONS).forEach(function (old) {
+		delete weatherCache.locations[old];
+	});
+	storeWeatherCache();
+}
+
+// records from before saved was kept were only written when complete
+function recordSaved(record) {
+	return record.saved || record.updated || 0;
+}
+
+function storeWeatherCache() {
+	localStorage.setItem(WEATHER_CACHE_KEY, JSON.stringify(weatherCache));
+}
+
+// minutes since the location was last refreshed completely
+function weatherCacheAge(key) {
+	var record = weatherCache.locations[key];
+	if (!record || !record.updated) {
+		return Infinity;
+	}
+	return Math.floor((Date.now() - record.updated) / 60000);
+}
+
+
+//======================================
+// SEND CACHED DATA FROM PHONE
+//======================================
+function sendCachedWeather(key) {
+	var record = weatherCache.locations[key];
+	if (!record || !record.current) {
+		sendWeather(emptyWeather("no data", WEATHER_FLAG_NO_DATA));
+		return;
+	}
+	var current = record.current;
+	var forecast = record.forecast || { icon: 4, min_temp: null, max_temp: null };
+	var where = (current.latitude != null) ? current : (record.position || {}); // cached before coord was kept
+
+	// the watch formats everything, only convert units here
+	var flags = 0;
+	if (config.CONFIG_FAHRENHEIT == 1) {
+		flags |= WEATHER_FLAG_IMPERIAL;
+	}
+	if (!current.found) {
+		flags |= WEATHER_FLAG_NO_DATA; // city not found
+	}
+
+	sendWeather({
+		icon: current.icon,
+		forecast_icon: forecast.icon,
+		flags: flags,
+		temperature: current.found ? tempConverter(current.temperature) : 0,
+		min_temp: (forecast.min_temp != null) ? tempConverter(forecast.min_temp) : 0,
+		max_temp: (forecast.max_temp != null) ? tempConverter(forecast.max_temp) : 0,
+		wind: current.found ? windValue(current.windspeed) : 0,
+		latitude: where.latitude,
+		longitude: where.longitude,
+		sunrise: current.sunrise || 0,
+		sunset: current.sunset || 0,
+		city: current.city
+	}, current.found ? forecast.slots : null);
+}
+
+//======================================
+// LOCATION - reuse the last fix and weather while the user stays put
+// a coarse fix the phone may already have comes first, a fresh high
+// accuracy fix only when that fails or is too vague to compare
+//======================================
+var LOCATION_REUSE_KM = 5;     // a fix closer than this to the weather's position is the same place
+var LOCATION_MAX_AGE = 30;     // minutes a fix is trusted without asking the phone again
+var WEATHER_MAX_AGE = 45;      // minutes weather is reused, below the watch's hourly request
+var coarseLocationOptions = { "enableHighAccuracy": false, "maximumAge": LOCATION_MAX_AGE * 60000, "timeout": 15000 };
+var fineLocationOptions = { "enableHighAccuracy": true, "maximumAge": 0, "timeout": 72000 };
+var locationCounts = { day: new Date().toDateString(), coarse: 0, fine: 0, fetches: 0, reused: 0 };
+
+// location requests, weather fetches and reuses per day
+function countLocation(what) {
+	var today = new Date().toDateString();
+	if (today != locationCounts.day) {
+		console.log(locationCounts.day + ": " + locationCounts.coarse + " coarse and " + locationCounts.fine + " fine fixes, " +
+			locationCounts.fetches + " weather fetches, " + locationCounts.reused + " reused");
+		locationCounts = { day: today, coarse: 0, fine: 0, fetches: 0, reused: 0 };
+	}
+	locationCounts[what]++;
+}
+
+// equirectangular, plenty for a few km
+function distanceKm(a, b) {
+	var rad = Math.PI / 180;
+	var x = (b.longitude - a.longitude) * rad * Math.cos((a.latitude + b.latitude) / 2 * rad);
+	var y = (b.latitude - a.latitude) * rad;
+	return Math.sqrt(x * x + y * y) * 6371;
+}
+
+function refreshFromLocation() {
+	var last = weatherCache.position;
+	if (last && last.time && (Date.now() - last.time < LOCATION_MAX_AGE * 60000)) {
+		weatherForPosition(last, "last fix");
+		return;
 	}
-	else { 
-		//console.log("Error, no data in cache");
-		Pebble.sendAppMessage({
-          "WEATHER_ICON":4,
-          "WEATHER_SUNTIMES":"",
-          "WEATHER_FORECASTICON":4,
-          "WEATHER_MINMAXTEMP":"",
-          "WEATHER_TEMPERATURE":"",
-          "WEATHER_CITY":"no data"
-  		});
+	countLocation("coarse");
+	window.navigator.geolocation.getCurrentPosition(function (pos) {
+		if (pos.coords.accuracy > LOCATION_REUSE_KM * 1000) {
+			fineLocation(); // too vague to tell if we moved
+			return;
+		}
+		locationSuccess(pos);
+	}, fineLocation, coarseLocationOptions);
+}
+
+function fineLocation() {
+	countLocation("fine");
+	window.navigator.geolocation.getCurrentPosition(locationSuccess, locationError, fineLocationOptions);
+}
+
+// cached weather if it is fresh and for about the same place, else fetch
+function weatherForPosition(here, source) {
+	var record = weatherCache.locations[locationKey(null)];
+	if (record && record.position && (weatherCacheAge(locationKey(null)) < WEATHER_MAX_AGE)) {
+		var moved = distanceKm(here, record.position);
+		if (moved < LOCATION_REUSE_KM) {
+			countLocation("reused");
+			sendCachedWeather(locationKey(null));
+			refreshDone("reused weather from " + source + ", " + moved.toFixed(1) + " km away");
+			return;
+		}
 	}
+	countLocation("fetches");
+	fetchWeather(null, here.latitude, here.longitude);
 }
 
 //======================================
 // LOCATION SUCCESS - fetch weather and forecast data
 //======================================
 function locationSuccess(pos) {
-  	var coordinates = pos.coords;
-  	fetchWeather(null, coordinates.latitude, coordinates.longitude);
-//    console.log("Coordinates " + coordinates.latitude + " ," + coordinates.longitude);
+	var coordinates = pos.coords;
+	weatherCache.position = { latitude: coordinates.latitude, longitude: coordinates.longitude, time: Date.now() };
+	storeWeatherCache();
+	weatherForPosition(weatherCache.position, "new fix");
 }
 
 //======================================
@@ -267,18 +765,12 @@ function locationSuccess(pos) {
 //======================================
 function locationError(err) {
 	//console.log('location error (' + err.code + '): ' + err.message);
-	if (localStorage.getItem("latitude") != null) {
-        fetchWeather(null, localStorage.getItem("latitude"), localStorage.getItem("longitude"));
+	if (weatherCache.position != null) {
+		weatherForPosition(weatherCache.position, "old fix");
 	}
 	else {
-  		Pebble.sendAppMessage({
-          "WEATHER_ICON":4,
-          "WEATHER_SUNTIMES":"",
-          "WEATHER_FORECASTICON":4,
-          "WEATHER_MINMAXTEMP":"",
-  		  "WEATHER_TEMPERATURE":"GPS",
-          "WEATHER_CITY":"no GPS"
-  		});
+		sendWeather(emptyWeather("no GPS", WEATHER_FLAG_NO_GPS));
+		refreshDone("failed (no location)");
 	}
 }
 
@@ -289,8 +781,8 @@ function defaultConfig() {
 	o={};
     o["CONFIG_REVERSE"]=0;		// black background layout
     o["CONFIG_COLORTICKS"]=1;
-	o["CONFIG_24H"]=1; 			// use 24 hour time
 	o["CONFIG_SECONDS"]=1;      // show second hand
+	o["CONFIG_SECONDSWINDOW"]=30; // second hand runs 30 seconds after a tap, 0 always
 	o["CONFIG_HOURVIBES"]=0;	// don't vibrate on the hour
 	o["CONFIG_FAHRENHEIT"]=0;   // use metric units
     o["CONFIG_CITYID"]=0;		// no city ID, use city name or GPS
@@ -303,15 +795,30 @@ function defaultConfig() {
 //======================================
 // SEND CONFIG TO WATCH
 //======================================
+// only the values the watch doesn't have yet
 function sendConfig() {
-    Pebble.sendAppMessage({
-      "CONFIG_REVERSE": config.CONFIG_REVERSE,
-      "CONFIG_COLORTICKS": config.CONFIG_COLORTICKS,
-      "CONFIG_SECONDS":config.CONFIG_SECONDS,
-      "CONFIG_HOURVIBES":config.CONFIG_HOURVIBES,
-      "CONFIG_DISTANCE": config.CONFIG_DISTANCE,
-      "CONFIG_BLUETHEME": config.CONFIG_BLUETHEME,
-      });
+    var keys = ["CONFIG_REVERSE", "CONFIG_COLORTICKS", "CONFIG_SECONDS", "CONFIG_HOURVIBES", "CONFIG_DISTANCE", "CONFIG_BLUETHEME", "CONFIG_SECONDSWINDOW"];
+    var changed = {};
+    var count = 0;
+    keys.forEach(function (key) {
+        if (lastSentConfig[key] !== config[key]) {
+            changed[key] = config[key];
+            count++;
+        }
+    });
+    if (count == 0) {
+        countSuppressed("config");
+        return;
+    }
+    Pebble.sendAppMessage(changed,
+        function (e) {
+            for (var key in changed) {
+                lastSentConfig[key] = changed[key];
+            }
+        },
+        function (e) {
+            console.log("config message not delivered");
+        });
 }
 
 //======================================
@@ -325,31 +832,25 @@ Pebble.addEventListener("ready", function(e) {
 		//load default config
 		config = defaultConfig();
 	}
-//	console.log("config is " + JSON.stringify(config));
+	delete config.CONFIG_24H; // sun times follow the watch's own 12/24h setting now
+//    console.log("config is " + JSON.stringify(config));
+    resetDeltaSync();
     sendConfig();
+    if (TELEMETRY) {
+        setTimeout(requestTelemetry, 5000); // after config and weather are through
+    }
                         
-	// load cached data if less than 58 minutes, otherwise fetch fresh data
-	var current_time = new Date();
-	var weather_timestamp = new Date(localStorage.getItem("weather_timestamp"));
-	var timediff = Math.floor(current_time.getTime()/1000/60) - Math.floor(weather_timestamp.getTime()/1000/60);
-	console.log("Time diff is " + timediff);
-	if (timediff < 60) {
+	// load cached data if it is fresh, otherwise refresh
+	loadWeatherCache();
+	var key = configLocationKey();
+	var timediff = weatherCacheAge(key);
+	console.log("Cache age is " + timediff + " min");
+	if (timediff < WEATHER_MAX_AGE) {
 	  	console.log("Within refresh limit, loading cached data");
-		readCachedData();
+		sendCachedWeather(key);
 	}
 	else {		
-		// load weather using favorite city name, else city ID, else use GPS location
-		if ((config.CONFIG_SETCITY != "") && (config.CONFIG_SETCITY != "undefined")) {
-			console.log("Loading config setcity " + config.CONFIG_SETCITY);
-			fetchWeather(config.CONFIG_SETCITY, null, null);
-		}
-        else {
-            console.log("Loading from GPS position");
-            locationWatcher = window.navigator.geolocation.getCurrentPosition(locationSuccess, locationError, locationOptions);
-        }
-        if (newForecastLoaded = true) {
-            readCachedData();
-        }
+		refreshWeather("ready", false);
 	}
 });
 
@@ -357,13 +858,11 @@ Pebble.addEventListener("ready", function(e) {
 // ON APPMESSAGE RECEIVED - fetch fresh data
 //======================================
 Pebble.addEventListener("appmessage", function(e) {	
-	if ((config.CONFIG_SETCITY != "") || (config.CONFIG_SETCITY != "undefined")) {
-		fetchWeather(config.CONFIG_SETCITY, null, null);
+	if (e.payload.TELEMETRY_DATA) {
+		receiveTelemetry(e.payload.TELEMETRY_DATA);
+		return;
 	}
-	else {
-        locationWatcher = window.navigator.geolocation.getCurrentPosition(locationSuccess, locationError, locationOptions);
-	}
-
+	refreshWeather("watch", false);
 });
  
 //======================================
@@ -373,7 +872,7 @@ Pebble.addEventListener("appmessage", function(e) {
 Pebble.addEventListener("showConfiguration", function(e) {
 	prevcity = config.CONFIG_SETCITY; // set previous city before opening config window
 	Pebble.openURL("data:text/html,"+encodeURIComponent(
-	'<!DOCTYPE html><html><head><meta name="viewport" content="width=device-width, initial-scale=1"></head><body><header><h1><span>TechRad 2.7</span></h1></header><form onsubmit="return s(this)"><p><input type="checkbox" id="CONFIG_REVERSE" class="showhide"><label for="CONFIG_REVERSE">Reversed layout with white background<br>(default is black background)</label><p><input type="checkbox" id="CONFIG_BLUETHEME" class="showhide"><label for="CONFIG_BLUETHEME">Blue theme for graphics<br>(default is red)</label><p><input type="checkbox" id="CONFIG_24H" class="showhide"><label for="CONFIG_24H">24 hour time<br>(default is 12 hour am/pm time)</label><p><input type="checkbox" id="CONFIG_SECONDS" class="showhide"><label for="CONFIG_SECONDS">Show second hand</label><p><input type="checkbox" id="CONFIG_HOURVIBES" class="showhide"><label for="CONFIG_HOURVIBES">Vibrate at the start of every hour</label><p><input type="checkbox" id="CONFIG_FAHRENHEIT" class="showhide"><label for="CONFIG_FAHRENHEIT">Use Fahrenheit for temperature and mph for windspeed<br>(default is Centigrade and km/h)</label><p><input type="checkbox" id="CONFIG_DISTANCE" class="showhide"><label for="CONFIG_DISTANCE">Show distance walked<br>(default is no. of steps walked)</label><p><input type="checkbox" id="CONFIG_CITYID" class="showhide"><label for="CONFIG_CITYID">Use OpenWeathermap city ID<br>(default is to search for city name)</label><p><input type="text" id="CONFIG_SETCITY" class="showhide"><label for="CONFIG_SETCITY"><br>Set city name or city ID (leave empty to use GPS)</label><p><p><input type="submit" value="Save Settings"></form><p><footer>By Mango Lazi</footer><script>function s(e){o={};o["CONFIG_REVERSE"]=document.getElementById("CONFIG_REVERSE").checked?1:0;o["CONFIG_BLUETHEME"]=document.getElementById("CONFIG_BLUETHEME").checked?1:0;o["CONFIG_24H"]=document.getElementById("CONFIG_24H").checked?1:0;o["CONFIG_SECONDS"]=document.getElementById("CONFIG_SECONDS").checked?1:0;o["CONFIG_HOURVIBES"]=document.getElementById("CONFIG_HOURVIBES").checked?1:0;o["CONFIG_FAHRENHEIT"]=document.getElementById("CONFIG_FAHRENHEIT").checked?1:0;o["CONFIG_DISTANCE"]=document.getElementById("CONFIG_DISTANCE").checked?1:0;o["CONFIG_CITYID"]=document.getElementById("CONFIG_CITYID").checked?1:0;o["CONFIG_SETCITY"]=document.getElementById("CONFIG_SETCITY").value;return window.location.href="pebblejs://close#"+JSON.stringify(o),!1}var d="_CONFDATA_";for(var i in d)d.hasOwnProperty(i)&&(document.getElementById(i).checked=d[i]);document.getElementById("CONFIG_SETCITY").value=d[i];</script></body></html>\n<!--.html'.replace('"_CONFDATA_"',JSON.stringify(config),"g")))});
+	'<!DOCTYPE html><html><head><meta name="viewport" content="width=device-width, initial-scale=1"></head><body><header><h1><span>TechRad 2.7</span></h1></header><form onsubmit="return s(this)"><p><input type="checkbox" id="CONFIG_REVERSE" class="showhide"><label for="CONFIG_REVERSE">Reversed layout with white background<br>(default is black background)</label><p><input type="checkbox" id="CONFIG_BLUETHEME" class="showhide"><label for="CONFIG_BLUETHEME">Blue theme for graphics<br>(default is red)</label><p><input type="checkbox" id="CONFIG_SECONDS" class="showhide"><label for="CONFIG_SECONDS">Show second hand</label><p><input type="number" id="CONFIG_SECONDSWINDOW" min="0" max="255" class="showhide"><label for="CONFIG_SECONDSWINDOW"><br>Seconds the second hand runs after a tap or wrist flick<br>(0 keeps it running all the time)</label><p><input type="checkbox" id="CONFIG_HOURVIBES" class="showhide"><label for="CONFIG_HOURVIBES">Vibrate at the start of every hour</label><p><input type="checkbox" id="CONFIG_FAHRENHEIT" class="showhide"><label for="CONFIG_FAHRENHEIT">Use Fahrenheit for temperature and mph for windspeed<br>(default is Centigrade and km/h)</label><p><input type="checkbox" id="CONFIG_DISTANCE" class="showhide"><label for="CONFIG_DISTANCE">Show distance walked<br>(default is no. of steps walked)</label><p><input type="checkbox" id="CONFIG_CITYID" class="showhide"><label for="CONFIG_CITYID">Use OpenWeathermap city ID<br>(default is to search for city name)</label><p><input type="text" id="CONFIG_SETCITY" class="showhide"><label for="CONFIG_SETCITY"><br>Set city name or city ID (leave empty to use GPS)</label><p><p><input type="submit" value="Save Settings"></form><p><footer>By Mango Lazi</footer><script>function s(e){o={};o["CONFIG_REVERSE"]=document.getElementById("CONFIG_REVERSE").checked?1:0;o["CONFIG_BLUETHEME"]=document.getElementById("CONFIG_BLUETHEME").checked?1:0;o["CONFIG_SECONDS"]=document.getElementById("CONFIG_SECONDS").checked?1:0;o["CONFIG_SECONDSWINDOW"]=Math.min(255,Math.max(0,parseInt(document.getElementById("CONFIG_SECONDSWINDOW").value,10)||0));o["CONFIG_HOURVIBES"]=document.getElementById("CONFIG_HOURVIBES").checked?1:0;o["CONFIG_FAHRENHEIT"]=document.getElementById("CONFIG_FAHRENHEIT").checked?1:0;o["CONFIG_DISTANCE"]=document.getElementById("CONFIG_DISTANCE").checked?1:0;o["CONFIG_CITYID"]=document.getElementById("CONFIG_CITYID").checked?1:0;o["CONFIG_SETCITY"]=document.getElementById("CONFIG_SETCITY").value;return window.location.href="pebblejs://close#"+JSON.stringify(o),!1}var d="_CONFDATA_";document.getElementById("CONFIG_SECONDSWINDOW").value=null!=d.CONFIG_SECONDSWINDOW?d.CONFIG_SECONDSWINDOW:30;for(var i in d)d.hasOwnProperty(i)&&(document.getElementById(i).checked=d[i]);document.getElementById("CONFIG_SETCITY").value=d[i];</script></body></html>\n<!--.html'.replace('"_CONFDATA_"',JSON.stringify(config),"g")))});
 
 
 //======================================
@@ -383,13 +882,5 @@ Pebble.addEventListener("webviewclosed", function(e) {
 	"string"==typeof e.response && e.response.length>0 && (config=JSON.parse(e.response),localStorage.setItem("techradconfig",e.response));
 	console.log("New config " + JSON.stringify(e.response));
     sendConfig();
-//    readCachedData();
-    if (config.CONFIG_SETCITY != "") {
-//            console.log("New config fetch setcity " + config.CONFIG_SETCITY);
-            fetchWeather(config.CONFIG_SETCITY, null, null);
-    }
-    else {
-//        console.log("New config fetch GPS");
-        locationWatcher = window.navigator.geolocation.getCurrentPosition(locationSuccess, locationError, locationOptions);
-    }
+    refreshWeather("config", true); // city or units may have changed
 });
\ No newline at end of file
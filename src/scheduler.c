@@ -0,0 +1,229 @@
+//======================================
+// TECHRAD job scheduler
+// Jobs sit in the slot of the minute they run next, longer periods
+// count down rounds, so a tick only looks at the jobs in one slot
+//======================================
+
+#include "scheduler.h"
+
+static SchedulerJob *s_wheel[SCHEDULER_SLOTS];
+static uint8_t s_cursor;            // last slot processed
+static uint16_t s_minute_of_day;    // minutes since midnight at the cursor
+static int32_t s_wall_minute;       // scheduler_wall_minute at the cursor
+
+
+//======================================
+// WHEEL
+//======================================
+// place a job delay minutes after the cursor
+static void scheduler_insert(SchedulerJob *job, uint16_t delay) {
+    job->slot = (s_cursor + delay) % SCHEDULER_SLOTS;
+    job->rounds = (delay - 1) / SCHEDULER_SLOTS;
+    job->next = s_wheel[job->slot];
+    s_wheel[job->slot] = job;
+}
+
+// minutes until the next aligned run, at least 1
+static uint16_t scheduler_delay(const SchedulerJob *job) {
+    uint16_t period = job->period ? job->period : 1;
+    int32_t phase = ((int32_t)s_minute_of_day - job->offset) % period;
+    if (phase < 0) {
+        phase += period;
+    }
+    return period - phase;
+}
+
+static void scheduler_unlink(SchedulerJob *job) {
+    SchedulerJob **link = &s_wheel[job->slot];
+    while (*link) {
+        if (*link == job) {
+            *link = job->next;
+            job->next = NULL;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+
+// minutes since 1900 on the wall clock, unlike time() this goes back
+// when the clock is set back, a time zone change or the end of DST
+static int32_t scheduler_wall_minute(const struct tm *t) {
+    int32_t years = t->tm_year + 1900 - 1; // whole years before this one
+    int32_t leap_days = (years / 4 - years / 100 + years / 400) - (1899 / 4 - 1899 / 100 + 1899 / 400);
+    int32_t days = t->tm_year * 365 + leap_days + t->tm_yday;
+    return (days * 24 + t->tm_hour) * 60 + t->tm_min;
+}
+
+// put the cursor on this minute
+static void scheduler_cursor_set(const struct tm *now) {
+    s_cursor = now->tm_min;
+    s_minute_of_day = now->tm_hour * 60 + now->tm_min;
+    s_wall_minute = scheduler_wall_minute(now);
+}
+
+
+//======================================
+// RUNNING JOBS
+//======================================
+static void scheduler_run(SchedulerJob *job) {
+    job->fired++;
+    job->callback();
+}
+
+static void scheduler_jitter_callback(void *data) {
+    SchedulerJob *job = data;
+    job->timer = NULL;
+    scheduler_run(job);
+}
+
+// run now, or after a random part of the jitter so phone requests don't all land on the tick
+static void scheduler_fire(SchedulerJob *job) {
+    if (job->jitter_ms == 0) {
+        scheduler_run(job);
+    }
+    else if (job->timer == NULL) { // a run still waiting covers this one
+        job->timer = app_timer_register(rand() % job->jitter_ms, scheduler_jitter_callback, job);
+    }
+}
+
+// run the jobs due in the cursor slot and put them back one period later
+static void scheduler_advance(void) {
+    SchedulerJob *job = s_wheel[s_cursor];
+    s_wheel[s_cursor] = NULL;
+
+    while (job) {
+        SchedulerJob *next = job->next;
+        if (job->rounds > 0) {
+            job->rounds--;
+            job->next = s_wheel[s_cursor];
+            s_wheel[s_cursor] = job;
+        }
+        else {
+            scheduler_fire(job);
+            scheduler_insert(job, job->period ? job->period : 1);
+        }
+        job = next;
+    }
+}
+
+
+//======================================
+// RESYNC
+//======================================
+// minutes from the cursor to the job's next run
+static int32_t scheduler_pending(const SchedulerJob *job) {
+    int32_t minutes = (job->slot + SCHEDULER_SLOTS - s_cursor) % SCHEDULER_SLOTS;
+    return (minutes ? minutes : SCHEDULER_SLOTS) + job->rounds * SCHEDULER_SLOTS;
+}
+
+// move the cursor to now and put every job back at its next aligned minute from there
+// jobs that came due in the missed minutes before now run once, after they are back on the wheel
+// so their callbacks may change periods, a pending jittered run still goes ahead
+static void scheduler_resync(const struct tm *now, int32_t missed) {
+    SchedulerJob *jobs = NULL;
+    for (int slot = 0; slot < SCHEDULER_SLOTS; ++slot) {
+        while (s_wheel[slot]) {
+            SchedulerJob *job = s_wheel[slot];
+            s_wheel[slot] = job->next;
+            job->due = scheduler_pending(job) <= missed;
+            job->next = jobs;
+            jobs = job;
+        }
+    }
+
+    scheduler_cursor_set(now);
+    while (jobs) {
+        SchedulerJob *next = jobs->next;
+        scheduler_insert(jobs, scheduler_delay(jobs));
+        jobs = next;
+    }
+
+    for (int slot = 0; slot < SCHEDULER_SLOTS; ++slot) {
+        for (SchedulerJob *job = s_wheel[slot], *next; job; job = next) {
+            next = job->next;
+            if (job->due) {
+                job->due = false;
+                scheduler_fire(job);
+            }
+        }
+    }
+}
+
+
+//======================================
+// PUBLIC
+//======================================
+void scheduler_init(const struct tm *now) {
+    scheduler_cursor_set(now);
+    srand(time(NULL));
+}
+
+void scheduler_add(SchedulerJob *job) {
+    job->timer = NULL;
+    job->fired = 0;
+    job->due = false;
+    scheduler_insert(job, scheduler_delay(job));
+}
+
+void scheduler_remove(SchedulerJob *job) {
+    scheduler_unlink(job);
+    if (job->timer) {
+        app_timer_cancel(job->timer);
+        job->timer = NULL;
+    }
+}
+
+void scheduler_set_period(SchedulerJob *job, uint16_t period) {
+    if (job->period == period) {
+        return;
+    }
+    scheduler_unlink(job);
+    job->period = period;
+    scheduler_insert(job, scheduler_delay(job));
+}
+
+// walks every minute since the last tick, so a skipped tick doesn't lose jobs
+// a clock set back has no minutes to walk, the wheel just moves to the new time
+// past an hour walking would run short jobs many times over, the wheel resyncs instead
+void scheduler_tick(const struct tm *now) {
+    int32_t target = scheduler_wall_minute(now);
+    if (target < s_wall_minute) {
+        scheduler_resync(now, 0);
+        return;
+    }
+
+    int32_t steps = target - s_wall_minute;
+    if (steps > SCHEDULER_SLOTS) { // asleep for over an hour or the clock jumped ahead
+        scheduler_resync(now, steps);
+        return;
+    }
+
+    while (steps-- > 0) {
+        s_cursor = (s_cursor + 1) % SCHEDULER_SLOTS;
+        s_minute_of_day = (s_minute_of_day + 1) % (24 * 60);
+        s_wall_minute++;
+        scheduler_advance();
+    }
+}
+
+void scheduler_log(void) {
+    for (int slot = 0; slot < SCHEDULER_SLOTS; ++slot) {
+        for (SchedulerJob *job = s_wheel[slot]; job; job = job->next) {
+            APP_LOG(APP_LOG_LEVEL_DEBUG, "job %s: %d runs, every %d min, next at :%02d +%d h",
+                    job->name, job->fired, job->period, job->slot, job->rounds);
+            job->fired = 0;
+        }
+    }
+}
+
+void scheduler_deinit(void) {
+    for (int slot = 0; slot < SCHEDULER_SLOTS; ++slot) {
+        for (SchedulerJob *job = s_wheel[slot]; job; job = job->next) {
+            if (job->timer) {
+                app_timer_cancel(job->timer);
+                job->timer = NULL;
+            }
+        }
+    }
+}
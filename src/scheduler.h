@@ -0,0 +1,51 @@
+//======================================
+// TECHRAD job scheduler
+// Timer wheel for the periodic jobs, one slot per minute of the hour
+// driven by the minute tick, jitter is spread out with app timers
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+#define SCHEDULER_SLOTS 60
+
+typedef void (*SchedulerCallback)(void);
+
+typedef struct SchedulerJob {
+    const char *name;            // for the log
+    SchedulerCallback callback;
+    uint16_t period;             // minutes between runs
+    uint16_t offset;             // runs when minutes since midnight minus offset is a multiple of period
+    uint16_t jitter_ms;          // random delay after the tick, 0 runs straight from the tick
+    // wheel state, owned by the scheduler
+    uint8_t slot;                // minute of the hour of the next run
+    uint8_t rounds;              // full turns of the wheel left before the next run
+    uint16_t fired;              // runs since the last scheduler_log
+    bool due;                    // came due in minutes the wheel skipped, runs once on the resync
+    AppTimer *timer;             // pending jittered run
+    struct SchedulerJob *next;   // next job in the same slot
+} SchedulerJob;
+
+// start the wheel at the current time
+void scheduler_init(const struct tm *now);
+
+// put a job on the wheel, it first runs at its next aligned minute
+void scheduler_add(SchedulerJob *job);
+
+// take a job off the wheel, cancelling a pending jittered run
+void scheduler_remove(SchedulerJob *job);
+
+// change how often a job runs, effective from now
+void scheduler_set_period(SchedulerJob *job, uint16_t period);
+
+// advance the wheel to this minute, runs every job that is due
+// after a jump of over an hour each job that came due runs once, then every job
+// goes to its next aligned minute, if the clock was set back nothing runs
+void scheduler_tick(const struct tm *now);
+
+// log and reset the run count of every job
+void scheduler_log(void);
+
+// cancel all pending jittered runs
+void scheduler_deinit(void);
@@ -0,0 +1,118 @@
+//======================================
+// TECHRAD persistent storage
+// Record layout in flash: magic, version, CRC-16 of the payload, payload
+//======================================
+
+#include "storage.h"
+
+#define STORAGE_MAGIC 0xA5 // never the first byte of a pre-header struct
+
+typedef struct StorageHeader {
+    uint8_t magic;
+    uint8_t version;
+    uint16_t crc;
+} __attribute__((__packed__)) StorageHeader;
+
+
+//======================================
+// CRC
+//======================================
+// CRC-16/CCITT, bitwise to keep it small
+static uint16_t storage_crc(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+
+//======================================
+// LOAD
+//======================================
+bool storage_load(StorageRecord *record) {
+    uint8_t buffer[PERSIST_DATA_MAX_LENGTH];
+    int stored = persist_get_size(record->key);
+    if (stored <= 0) {
+        return false;
+    }
+    if (stored > (int)sizeof(buffer)) {
+        stored = sizeof(buffer);
+    }
+    stored = persist_read_data(record->key, buffer, stored);
+    if (stored <= 0) {
+        return false;
+    }
+
+    // no header, this is a raw struct from before versioning
+    const StorageHeader *header = (const StorageHeader *)buffer;
+    uint8_t version = 0;
+    const uint8_t *payload = buffer;
+    size_t payload_size = stored;
+
+    if ((stored >= (int)sizeof(StorageHeader)) && (header->magic == STORAGE_MAGIC)) {
+        version = header->version;
+        payload = buffer + sizeof(StorageHeader);
+        payload_size = stored - sizeof(StorageHeader);
+        if (storage_crc(payload, payload_size) != header->crc) {
+            APP_LOG(APP_LOG_LEVEL_WARNING, "storage key %d: bad CRC, using defaults", (int)record->key);
+            return false;
+        }
+    }
+
+    if ((version == record->version) && (payload_size == record->size)) {
+        memcpy(record->data, payload, record->size);
+        return true;
+    }
+
+    // older layout, convert and rewrite it in the current one
+    if (record->migrate && record->migrate(version, payload, payload_size, record->data, record->size)) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "storage key %d: migrated from version %d", (int)record->key, version);
+        record->dirty = true;
+        return true;
+    }
+
+    APP_LOG(APP_LOG_LEVEL_WARNING, "storage key %d: unknown version %d, using defaults", (int)record->key, version);
+    return false;
+}
+
+
+//======================================
+// WRITE BEHIND
+//======================================
+void storage_mark_dirty(StorageRecord *record) {
+    record->dirty = true;
+}
+
+bool storage_flush(StorageRecord *record, bool force) {
+    time_t now = time(NULL);
+    if (!record->dirty) {
+        return false;
+    }
+    if (!force && (now - record->last_write < STORAGE_FLUSH_MINUTES * 60)) {
+        return false;
+    }
+
+    uint8_t buffer[PERSIST_DATA_MAX_LENGTH];
+    size_t size = record->size;
+    if (size > sizeof(buffer) - sizeof(StorageHeader)) {
+        APP_LOG(APP_LOG_LEVEL_ERROR, "storage key %d: record too large", (int)record->key);
+        return false;
+    }
+
+    StorageHeader header = {
+        .magic = STORAGE_MAGIC,
+        .version = record->version,
+        .crc = storage_crc(record->data, size)
+    };
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), record->data, size);
+    persist_write_data(record->key, buffer, sizeof(header) + size);
+
+    record->dirty = false;
+    record->last_write = now;
+    return true;
+}
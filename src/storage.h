@@ -0,0 +1,37 @@
+//======================================
+// TECHRAD persistent storage
+// Versioned, CRC checked records on top of persist_*_data
+// with write-behind so repeated changes cost one flash write
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+// a dirty record is written at most once per this many minutes
+#define STORAGE_FLUSH_MINUTES 15
+
+// convert an older layout of the record into the current one
+// version 0 is the raw struct written before records had headers
+typedef bool (*StorageMigration)(uint8_t version, const uint8_t *old_data, size_t old_size, void *data, size_t size);
+
+typedef struct StorageRecord {
+    uint32_t key;              // persist key
+    uint8_t version;           // current layout version of data
+    void *data;                // live struct, loaded into and written from
+    size_t size;               // size of the live struct
+    StorageMigration migrate;  // may be NULL if there are no older layouts
+    bool dirty;                // changed since the last write
+    time_t last_write;         // when the record last went to flash
+} StorageRecord;
+
+// read the record into data, migrating older layouts
+// returns false and leaves data untouched if nothing valid is stored
+bool storage_load(StorageRecord *record);
+
+// note that data changed, it goes to flash with the next flush
+void storage_mark_dirty(StorageRecord *record);
+
+// write a dirty record if the last write is old enough, or always if forced
+// returns true if flash was written
+bool storage_flush(StorageRecord *record, bool force);
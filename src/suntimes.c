@@ -0,0 +1,111 @@
+//======================================
+// TECHRAD sun times
+// The sunrise equation, with angles in trig lookup units (TRIG_MAX_ANGLE
+// per turn) and time in seconds since J2000, 2000-01-01 12:00 UTC
+//======================================
+
+#include "suntimes.h"
+
+#define J2000_EPOCH 946728000       // J2000 as a UTC epoch
+#define SECONDS_PER_DAY 86400
+
+// constants of the equation in trig units, or seconds for the transit terms
+#define ANOMALY_J2000 65087         // mean anomaly at J2000, 357.5291 deg
+#define ANOMALY_RATE 1794245        // mean anomaly per day, 0.98560028 deg, in trig units times 10000
+#define CENTER_1 34858              // equation of center, 1.9148 deg, times 100
+#define CENTER_2 364                // 0.0200 deg, times 100
+#define PERIHELION 51508            // 180 + 102.9372 deg
+#define TILT 4267                   // axial tilt, 23.44 deg
+#define HORIZON 152                 // refraction and sun disc, -0.833 deg
+#define TRANSIT_ANOMALY 458         // 0.0053 days
+#define TRANSIT_ECLIPTIC 596        // 0.0069 days
+
+
+//======================================
+// HELPERS
+//======================================
+static int32_t angle_wrap(int64_t angle) {
+    angle %= TRIG_MAX_ANGLE;
+    return (angle < 0) ? angle + TRIG_MAX_ANGLE : angle;
+}
+
+// ratio times a trig lookup, still a ratio
+static int32_t ratio_mul(int32_t a, int32_t b) {
+    return ((int64_t)a * b) / TRIG_MAX_RATIO;
+}
+
+static uint32_t isqrt(uint32_t value) {
+    uint32_t root = 0, bit = 1UL << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// angle between 0 and half a turn whose cosine is ratio, cos_lookup falls over that range
+static int32_t acos_lookup(int32_t ratio) {
+    int32_t low = 0, high = TRIG_MAX_ANGLE / 2;
+    while (low < high) {
+        int32_t mid = (low + high) / 2;
+        if (cos_lookup(mid) > ratio) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+
+//======================================
+// SUNRISE EQUATION
+//======================================
+bool suntimes_compute(time_t midnight, int16_t latitude, int16_t longitude, time_t *sunrise, time_t *sunset) {
+    if (latitude == SUNTIMES_NO_LOCATION) {
+        return false;
+    }
+
+    // mean solar noon at this longitude, on the J2000 day closest to local noon
+    int32_t longitude_seconds = (int32_t)longitude * 12 / 5;   // 240 s per degree
+    int64_t local_noon = (int64_t)midnight + SECONDS_PER_DAY / 2 - J2000_EPOCH;
+    int64_t n = (local_noon + longitude_seconds + SECONDS_PER_DAY / 2) / SECONDS_PER_DAY;
+    int64_t noon = n * SECONDS_PER_DAY - longitude_seconds;
+
+    // solar mean anomaly, equation of center, ecliptic longitude
+    int32_t anomaly = angle_wrap(ANOMALY_J2000 + noon * ANOMALY_RATE / ((int64_t)SECONDS_PER_DAY * 10000));
+    int32_t center = ((int64_t)CENTER_1 * sin_lookup(anomaly) + (int64_t)CENTER_2 * sin_lookup(angle_wrap(2 * anomaly))) / (100 * TRIG_MAX_RATIO);
+    int32_t ecliptic = angle_wrap((int64_t)anomaly + center + PERIHELION);
+
+    // solar transit
+    int64_t transit = noon + (int64_t)TRANSIT_ANOMALY * sin_lookup(anomaly) / TRIG_MAX_RATIO
+                           - (int64_t)TRANSIT_ECLIPTIC * sin_lookup(angle_wrap(2 * (int64_t)ecliptic)) / TRIG_MAX_RATIO;
+
+    // declination of the sun
+    int32_t sin_declination = ratio_mul(sin_lookup(ecliptic), sin_lookup(TILT));
+    int32_t cos_declination = isqrt((uint32_t)TRIG_MAX_RATIO * TRIG_MAX_RATIO - (uint32_t)(sin_declination * sin_declination));
+
+    // hour angle of sunrise and sunset
+    int32_t phi = (int32_t)latitude * (TRIG_MAX_ANGLE / 4) / 9000;
+    int32_t numerator = -sin_lookup(HORIZON) - ratio_mul(sin_lookup(angle_wrap(phi)), sin_declination);
+    int32_t denominator = ratio_mul(cos_lookup(angle_wrap(phi)), cos_declination);
+    if ((denominator <= 0) || (numerator >= denominator) || (numerator <= -denominator)) {
+        return false; // polar day or night
+    }
+    int32_t hour_angle = acos_lookup((int64_t)numerator * TRIG_MAX_RATIO / denominator);
+    int32_t half_day = (int64_t)hour_angle * SECONDS_PER_DAY / TRIG_MAX_ANGLE;
+
+    *sunrise = J2000_EPOCH + transit - half_day;
+    *sunset = J2000_EPOCH + transit + half_day;
+    return true;
+}
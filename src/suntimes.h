@@ -0,0 +1,16 @@
+//======================================
+// TECHRAD sun times
+// Sunrise and sunset from latitude, longitude and date
+// integer math only, aplite has no FPU
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+#define SUNTIMES_NO_LOCATION INT16_MIN // latitude when the position is unknown
+
+// sunrise and sunset as UTC epochs for the local day starting at midnight
+// positions are hundredths of a degree, north and east positive
+// returns false if the sun doesn't rise or set that day
+bool suntimes_compute(time_t midnight, int16_t latitude, int16_t longitude, time_t *sunrise, time_t *sunset);
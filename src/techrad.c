@@ -6,38 +6,135 @@
 //======================================
 
 #include "techrad.h" // hour ticks and hand designs in here
+#include "hand_poses.h" // hand rotations, generated from techrad.h by tools/generate_hand_poses.py
+#include "hand_raster.h" // hands drawn straight into the frame buffer
+#include "storage.h" // versioned persist records with write-behind
+#include "scheduler.h" // periodic jobs, run from the minute tick
+#include "telemetry.h" // field frame costs for the phone, TELEMETRY in there
+#include "suntimes.h" // sunrise and sunset computed on the watch
+#include "format.h" // label text without snprintf
+#include "weather_icons.h" // weather icons as vector commands, colored by the theme
 #include "pebble.h"
 
+// set to 1 to log redraw counters and frame costs to the app log
+#ifndef DEBUG_PROFILE
+#define DEBUG_PROFILE 0
+#endif
+// set to 1 to run the render benchmark once on load, results go to the app log
+#ifndef DEBUG_BENCHMARK
+#define DEBUG_BENCHMARK 0
+#endif
+
 static Window *window;
 static GFont custom_font_numerals;
-static GColor color_background, color_ticks, color_maintext, color_cornertext, color_maintextbackground, color_cornertextbackground, color_second, color_hand_fill, color_hand_stroke, color_center_fill, color_center_stroke;
-static Layer *s_simple_bg_layer, *s_date_layer, *s_hands_layer;
-static TextLayer *s_label_12, *s_label_4, *s_label_8; // number labels
-static TextLayer *s_day_label, *s_battery_label, *s_suntimes_label, *s_temperature_label, *s_minmaxtemp_label, *s_city_label, *s_misc_label, *s_fitness_label; // information labels
-static char s_day_buffer[18], s_battery_buffer[4]; // buffers for information labels
-#if defined(PBL_HEALTH)
-static char s_fitness_buffer[10];
-#endif
+// colors of the current theme, see COLOR HANDLER
+typedef struct ThemePalette {
+    GColor background;
+    GColor ticks;
+    GColor maintext;        // numerals, date, temperature
+    GColor cornertext;      // battery, sun times, min-max, misc, city, fitness
+    GColor second;
+    GColor hand_fill;
+    GColor hand_stroke;
+    GColor center_fill;
+    GColor center_stroke;
+    WeatherIconColors icons;
+} ThemePalette;
+
+static const ThemePalette *s_theme;
+static Layer *s_simple_bg_layer, *s_info_layer, *s_hands_layer, *s_seconds_layer, *s_center_layer;
+static char s_day_buffer[18], s_battery_buffer[8], s_fitness_buffer[10]; // buffers for information labels, fitness stays empty without health
 
-static bool weather_fetched = false; // new weather data fetched for 60 minute period
-static bool health_fetched = false; // new fitness data fetched
 static bool bluetooth_enabled = false; // check for bluetooth status
 
-// bitmaps and layers for weather, forecast and bluetooth icons
-static BitmapLayer *s_icon_layer;
-static GBitmap *s_icon_bitmap = NULL;
-static BitmapLayer *s_forecasticon_layer;
-static GBitmap *s_forecasticon_bitmap = NULL;
+// power governor stages, each one keeps the savings of the stages before it
+enum PowerStage {
+    POWER_NORMAL = 0,   // charging or above 30%
+    POWER_SAVE = 1,     // below 30%: no second hand
+    POWER_LOW = 2,      // below 20%: weather every 3 hours
+    POWER_CRITICAL = 3  // below 10%: no health updates
+};
+static uint8_t s_power_stage = POWER_NORMAL;
+
+// layers for weather, forecast and bluetooth icons
+static Layer *s_icon_layer;
+static Layer *s_forecasticon_layer;
 static BitmapLayer *s_bluetooth_layer;
 static GBitmap *s_bluetooth_bitmap = NULL;
 
 // background hour ticks and arrows
+// the arrows point at writable buffers that get filled from the pose tables
 static GPath *s_tick_paths[NUM_CLOCK_TICKS];
 static GPath *s_minute_arrow, *s_hour_arrow;
+static GPoint s_minute_pose[MINUTE_HAND_POSE_POINTS], s_hour_pose[HOUR_HAND_POSE_POINTS];
+static const GPathInfo MINUTE_POSE_INFO = { MINUTE_HAND_POSE_POINTS, s_minute_pose };
+static const GPathInfo HOUR_POSE_INFO = { HOUR_HAND_POSE_POINTS, s_hour_pose };
+
+// pre-rendered dial: background, hour ticks and 12/4/8 numerals
+// drawn once per theme, then copied into the frame buffer every frame
+static GBitmap *s_dial_cache = NULL;
+static bool s_dial_cache_valid = false;
+
+// frames for a second tick only restore the old second hand from the dial cache
+// and draw the new one, the rest of the frame buffer is kept from the last frame
+// text and icons are left alone in those frames unless the old hand crossed them
+static bool s_compositor_partial = false; // the frame being drawn only moves the second hand
+static HandRasterRows s_second_rows;      // pixels of the second hand on screen
+static HandRasterRows s_damage_rows;      // one damaged frame at a time, see s_compositor_damage
+
+// anything other than the second hand changes, the next frame is drawn in full
+static void compositor_invalidate(void) {
+    s_compositor_partial = false;
+}
+
+// redraw counters, logged from the tick handler
+#if DEBUG_PROFILE
+static struct {
+    uint16_t layers_marked; // layers invalidated by the last tick
+    uint16_t layers_drawn;  // update procs run since the last tick
+    uint16_t dial_renders;  // dial drawn from scratch
+    uint16_t dial_blits;    // dial copied from the cache
+    uint32_t dial_render_ms;
+    uint32_t dial_blit_ms;
+    uint16_t resource_loads; // bitmaps loaded from resources this hour
+    uint16_t health_queries; // health service calls this hour
+    uint16_t messages_suppressed; // tuples from the phone that changed nothing, today
+    uint16_t redraws_suppressed;  // text and icon updates skipped, today
+    uint16_t flash_writes;        // storage records written, today
+    uint16_t flash_writes_suppressed; // unchanged weather that needed no write
+    uint16_t weather_requests_skipped; // hourly requests the timeline made unnecessary, today
+    uint16_t second_ticks;        // second ticks this minute
+    uint32_t second_ticks_avoided; // second ticks skipped by the seconds window, today
+    uint32_t pixels_written;      // frame buffer pixels our procs wrote since the last tick
+} s_stats;
+#define STATS_INC(field) (s_stats.field++)
+#define STATS_ADD(field, value) (s_stats.field += (value))
+#else
+#define STATS_INC(field)
+#define STATS_ADD(field, value) ((void)(value)) // value may be the draw call itself
+#endif
+
+#if DEBUG_PROFILE || DEBUG_BENCHMARK
+static uint32_t profile_time_ms(void) {
+    time_t seconds;
+    uint16_t millis;
+    time_ms(&seconds, &millis);
+    return (uint32_t)seconds * 1000 + millis;
+}
+#endif
+
+// time shown by the draw procs, captured once per tick so every layer
+// of a frame sees the same time without calling localtime again
+// the benchmark sets its own fake time here
+static struct tm s_frame_time;
+
+static void frame_time_set(time_t now) {
+    s_frame_time = *localtime(&now);
+}
 
-// appsync stuff
+// appsync stuff, sized for the packed weather record plus the config tuples
 static AppSync s_sync;
-static uint8_t s_sync_buffer[256];
+static uint8_t s_sync_buffer[192];
 
 // preferences, stored in watch persistent storage
 typedef struct persist {
@@ -46,6 +143,7 @@ typedef struct persist {
     uint8_t reverse; // reverse display: white background with black text, default false
     uint8_t distance; // steps unit: km or miles, default no. of steps
     uint8_t bluetheme; // color theme: blue graphics, default red
+    uint8_t secondswindow; // seconds the second hand runs after a tap, 0 keeps it running
 } __attribute__((__packed__)) persist;
 
 persist settings = {
@@ -53,23 +151,27 @@ persist settings = {
     .hourvibes = 0, // vibrate at the start of every hour, default false
     .reverse = 0,   // reverse display: white background with black text, default false
     .distance = 0,  // show distance, default no. of steps walked
-    .bluetheme = 0  // blue theme, default red
+    .bluetheme = 0, // blue theme, default red
+    .secondswindow = 30 // second hand runs for 30 seconds after a tap
 };
 
 enum PersistKey {
     PERSIST_SETTINGS = 0,
-    PERSIST_WEATHERDATA = 1
+    PERSIST_WEATHERDATA = 1,
+    PERSIST_TIMELINE = 2
 };
 
 // struct for cached weather data
 typedef struct weatherdata {
     uint8_t icon_current;   // current weather icon
     uint8_t forecasticon;   // current weather icon
-    char temperature[5];       // temperature
+    char temperature[8];       // temperature, fits "-12" plus a UTF-8 degree sign
     char minmaxtemp[15];       // temperature
     char city[20];         // sunrise
     char suntimes[20];         // sunset
     char misc[15];         // city
+    int16_t latitude;      // last known position in hundredths of a degree, for the sun times
+    int16_t longitude;
 } __attribute__((__packed__)) weatherdata;
 
 weatherdata cachedWeather = {
@@ -79,12 +181,134 @@ weatherdata cachedWeather = {
     .minmaxtemp = "",
     .city = "",
     .suntimes = "",
-    .misc = ""
+    .misc = "",
+    .latitude = SUNTIMES_NO_LOCATION,
+    .longitude = 0
 };
 
+// layout versions of the stored structs, bump and extend the migration when they change
+#define SETTINGS_VERSION 2
+#define WEATHERDATA_VERSION 2
+
+// weatherdata as stored before records were versioned
+typedef struct weatherdata_v0 {
+    uint8_t icon_current;
+    uint8_t forecasticon;
+    char temperature[5];
+    char minmaxtemp[15];
+    char city[20];
+    char suntimes[20];
+    char misc[15];
+} __attribute__((__packed__)) weatherdata_v0;
+
+// older settings are a prefix of the current ones, version 0 just has no header
+// fields added since keep their defaults, anything shorter than version 0 is a torn record
+#define SETTINGS_V0_SIZE 5 // seconds to bluetheme
+static bool settings_migrate(uint8_t version, const uint8_t *old_data, size_t old_size, void *data, size_t size) {
+    if ((version >= SETTINGS_VERSION) || (old_size < SETTINGS_V0_SIZE)) {
+        return false;
+    }
+    memcpy(data, old_data, (old_size < size) ? old_size : size);
+    return true;
+}
+
+// weatherdata version 0 had a shorter temperature, copy field by field
+// version 1 had no position, it is the current layout up to the latitude
+static bool weatherdata_migrate(uint8_t version, const uint8_t *old_data, size_t old_size, void *data, size_t size) {
+    weatherdata *weather = data;
+    if ((version == 1) && (old_size == sizeof(weatherdata) - 2 * sizeof(int16_t))) {
+        memcpy(weather, old_data, old_size);
+        weather->latitude = SUNTIMES_NO_LOCATION;
+        weather->longitude = 0;
+        return true;
+    }
+    if ((version != 0) || (old_size != sizeof(weatherdata_v0))) {
+        return false;
+    }
+    weather->latitude = SUNTIMES_NO_LOCATION;
+    weather->longitude = 0;
+    const weatherdata_v0 *old = (const weatherdata_v0 *)old_data;
+    weather->icon_current = old->icon_current;
+    weather->forecasticon = old->forecasticon;
+    snprintf(weather->temperature, sizeof(weather->temperature), "%.*s", (int)sizeof(old->temperature) - 1, old->temperature);
+    snprintf(weather->minmaxtemp, sizeof(weather->minmaxtemp), "%.*s", (int)sizeof(old->minmaxtemp) - 1, old->minmaxtemp);
+    snprintf(weather->city, sizeof(weather->city), "%.*s", (int)sizeof(old->city) - 1, old->city);
+    snprintf(weather->suntimes, sizeof(weather->suntimes), "%.*s", (int)sizeof(old->suntimes) - 1, old->suntimes);
+    snprintf(weather->misc, sizeof(weather->misc), "%.*s", (int)sizeof(old->misc) - 1, old->misc);
+    return true;
+}
+
+// forecast slots pushed by the phone, the face steps through them without the radio
+// this is also the WEATHER_TIMELINE message layout, which only carries count slots
+#define WEATHER_TIMELINE_VERSION 1
+#define WEATHER_TIMELINE_SLOTS 16       // 48 hours of 3 hour forecast steps
+#define WEATHER_TIMELINE_MINMAX_SLOTS 4 // min-max over the next 12 hours, like the old forecast
+#define WEATHER_TIMELINE_REFETCH 2      // ask the phone again once this few slots are left
+
+typedef struct WeatherSlot {
+    uint8_t icon;           // weather icon id
+    int8_t temperature;     // degrees in the unit given by the timeline flags
+    uint8_t wind;           // km/h or mph
+} __attribute__((__packed__)) WeatherSlot;
+
+typedef struct WeatherTimeline {
+    uint8_t version;        // WEATHER_TIMELINE_VERSION
+    uint8_t flags;          // WeatherFlag bits the slots were converted with
+    uint8_t step;           // minutes between slots
+    uint8_t count;          // slots in use, 0 if there is no timeline
+    uint32_t start;         // UTC epoch seconds of slot 0
+    WeatherSlot slots[WEATHER_TIMELINE_SLOTS];
+} __attribute__((__packed__)) WeatherTimeline;
+
+static WeatherTimeline s_timeline;
+static int s_timeline_shown = -1; // slot the weather labels show
+#define WEATHER_TIMELINE_STORE_VERSION 1
+
+// settings and weather cache go to flash through the write-behind store
+static StorageRecord s_settings_store = {
+    .key = PERSIST_SETTINGS,
+    .version = SETTINGS_VERSION,
+    .data = &settings,
+    .size = sizeof(settings),
+    .migrate = settings_migrate
+};
+
+static StorageRecord s_weather_store = {
+    .key = PERSIST_WEATHERDATA,
+    .version = WEATHERDATA_VERSION,
+    .data = &cachedWeather,
+    .size = sizeof(cachedWeather),
+    .migrate = weatherdata_migrate
+};
+
+static StorageRecord s_timeline_store = {
+    .key = PERSIST_TIMELINE,
+    .version = WEATHER_TIMELINE_STORE_VERSION,
+    .data = &s_timeline,
+    .size = sizeof(s_timeline),
+    .migrate = NULL
+};
+
+// write dirty records, at most once per STORAGE_FLUSH_MINUTES unless forced
+static void storage_flush_all(bool force) {
+    if (storage_flush(&s_settings_store, force)) {
+        STATS_INC(flash_writes);
+        TELEMETRY_COUNT(TELEMETRY_PERSIST_WRITES);
+    }
+    if (storage_flush(&s_weather_store, force)) {
+        STATS_INC(flash_writes);
+        TELEMETRY_COUNT(TELEMETRY_PERSIST_WRITES);
+    }
+    if (storage_flush(&s_timeline_store, force)) {
+        STATS_INC(flash_writes);
+        TELEMETRY_COUNT(TELEMETRY_PERSIST_WRITES);
+    }
+}
+
 // appkeys, should match stuff in appinfo.json
+// weather now arrives as one WEATHER_PACKED record, keys 0x1-0x6 are no longer sent
 enum WeatherKey {
-    WEATHER_ICON = 0x0,         	// TUPLE_INT
+    WEATHER_ICON = 0x0,         	// TUPLE_INT, also used by the watch to request weather
     WEATHER_TEMPERATURE = 0x1,  	// TUPLE_CSTRING
     WEATHER_CITY = 0x2,         	// TUPLE_CSTRING
     WEATHER_SUNTIMES = 0x3, 		// TUPLE_CSTRING
@@ -95,42 +319,148 @@ enum WeatherKey {
     CONFIG_HOURVIBES = 0x8,			// TUPLE_INT
     CONFIG_BLUETHEME = 0x9,          // TUPLE_INT
     CONFIG_REVERSE = 0xA,			// TUPLE_INT
-    CONFIG_DISTANCE = 0xB          // TUPLE_INT
+    CONFIG_DISTANCE = 0xB,          // TUPLE_INT
+    WEATHER_PACKED = 0xC,           // TUPLE_BYTE_ARRAY, see WeatherRecord
+    CONFIG_SECONDSWINDOW = 0xD,     // TUPLE_INT
+    // 0xE and 0xF are TelemetryKey, see telemetry.h
+    WEATHER_TIMELINE = 0x10         // TUPLE_BYTE_ARRAY, see WeatherTimeline
 };
 
-// array for weather and forecast icons
-static const uint32_t WEATHER_ICONS[] = {
-  RESOURCE_ID_IMAGE_SUN,    //0
-  RESOURCE_ID_IMAGE_CLOUD,  //1
-  RESOURCE_ID_IMAGE_RAIN,   //2
-  RESOURCE_ID_IMAGE_SNOW,   //3
-  RESOURCE_ID_IMAGE_LOADING //4
-};
+// packed weather record sent by the phone, see packWeather() in pebble-js-app.js
+// multi byte values are little endian, display strings are formatted on the watch
+#define WEATHER_RECORD_VERSION 2
+#define WEATHER_CITY_MAX 19 // bytes of city name, not NUL terminated
 
-static const uint32_t WEATHER_ICONS_SMALL[] = {
-  RESOURCE_ID_IMAGE_SUN_SMALL,      //0
-  RESOURCE_ID_IMAGE_CLOUD_SMALL,    //1
-  RESOURCE_ID_IMAGE_RAIN_SMALL,     //2
-  RESOURCE_ID_IMAGE_SNOW_SMALL,     //3
-  RESOURCE_ID_IMAGE_LOADING_SMALL   //4
+enum WeatherFlag {
+    WEATHER_FLAG_IMPERIAL = 0x1,    // Fahrenheit and mph
+    WEATHER_FLAG_24H = 0x2,         // unused since version 2, the watch's own clock style decides
+    WEATHER_FLAG_NO_DATA = 0x4,     // no temperatures, wind or sun times
+    WEATHER_FLAG_NO_GPS = 0x8       // location failed
 };
 
-static const uint32_t WEATHER_ICONS_REVERSE[] = {
-    RESOURCE_ID_IMAGE_SUN_REVERSE,      //0
-    RESOURCE_ID_IMAGE_CLOUD_REVERSE,    //1
-    RESOURCE_ID_IMAGE_RAIN_REVERSE,     //2
-    RESOURCE_ID_IMAGE_SNOW_REVERSE,     //3
-    RESOURCE_ID_IMAGE_LOADING_REVERSE   //4
+typedef struct WeatherRecord {
+    uint8_t version;        // WEATHER_RECORD_VERSION
+    uint8_t icon;           // current weather icon
+    uint8_t forecasticon;   // forecast icon
+    uint8_t flags;          // WeatherFlag bits
+    int8_t temperature;     // degrees in the unit given by flags
+    int8_t temp_min;
+    int8_t temp_max;
+    uint8_t wind;           // km/h or mph
+    int16_t latitude;       // hundredths of a degree, INT16_MIN when unknown
+    int16_t longitude;      // hundredths of a degree
+    uint8_t city_length;
+    char city[];            // city_length bytes of UTF-8
+} __attribute__((__packed__)) WeatherRecord;
+
+//======================================
+// INFO TEXT
+//======================================
+// every information label is a slot in this table, one layer draws them all
+// the temperature sits on the center box, so the center layer draws that one
+enum InfoSlotId {
+    INFO_BATTERY,
+    INFO_FITNESS,
+    INFO_DAY,
+    INFO_SUNTIMES,
+    INFO_MINMAXTEMP,
+    INFO_MISC,
+    INFO_CITY,
+    INFO_TEMPERATURE,
+    INFO_SLOTS
 };
 
-static const uint32_t WEATHER_ICONS_SMALL_REVERSE[] = {
-    RESOURCE_ID_IMAGE_SUN_SMALL_REVERSE,    //0
-    RESOURCE_ID_IMAGE_CLOUD_SMALL_REVERSE,  //1
-    RESOURCE_ID_IMAGE_RAIN_SMALL_REVERSE,   //2
-    RESOURCE_ID_IMAGE_SNOW_SMALL_REVERSE,   //3
-    RESOURCE_ID_IMAGE_LOADING_SMALL_REVERSE //4
+// what a partial frame draws again besides the second hand, the info slots by id and these
+// frames are where the dial goes back and the hands are redrawn, see compositor_partial_possible
+enum { COMPOSITOR_FORECASTICON = INFO_SLOTS, COMPOSITOR_CENTER_BOX, COMPOSITOR_ITEMS };
+static uint16_t s_compositor_damage = 0; // bit per item
+static GRect s_compositor_damage_frame[COMPOSITOR_ITEMS];
+
+static bool compositor_damaged(uint8_t item) {
+    return s_compositor_partial && (s_compositor_damage & (1 << item));
+}
+
+enum InfoFont { INFO_FONT_SMALL, INFO_FONT_BOLD, INFO_FONTS };
+enum InfoColor { INFO_COLOR_MAIN, INFO_COLOR_CORNER }; // maintext or cornertext of the theme
+
+typedef struct InfoSlot {
+    GRect frame;               // on the 144x168 screen
+    uint8_t font;              // InfoFont
+    uint8_t alignment;         // GTextAlignment
+    uint8_t color;             // InfoColor
+    const char *text;
+} InfoSlot;
+
+static const InfoSlot INFO_SLOT_TABLE[INFO_SLOTS] = {
+    [INFO_BATTERY] = { { { 3, 0 }, { 40, 20 } }, INFO_FONT_SMALL, GTextAlignmentLeft, INFO_COLOR_CORNER, s_battery_buffer },
+    [INFO_FITNESS] = { { { 52, 150 }, { 40, 20 } }, INFO_FONT_SMALL, GTextAlignmentCenter, INFO_COLOR_CORNER, s_fitness_buffer },
+    [INFO_DAY] = { { { 42, 133 }, { 60, 25 } }, INFO_FONT_BOLD, GTextAlignmentCenter, INFO_COLOR_MAIN, s_day_buffer },
+    [INFO_SUNTIMES] = { { { 0, 30 }, { 40, 30 } }, INFO_FONT_SMALL, GTextAlignmentLeft, INFO_COLOR_CORNER, cachedWeather.suntimes },
+    [INFO_MINMAXTEMP] = { { { 102, 30 }, { 40, 15 } }, INFO_FONT_SMALL, GTextAlignmentRight, INFO_COLOR_CORNER, cachedWeather.minmaxtemp },
+    [INFO_MISC] = { { { 82, 45 }, { 60, 15 } }, INFO_FONT_SMALL, GTextAlignmentRight, INFO_COLOR_CORNER, cachedWeather.misc },
+    [INFO_CITY] = { { { 32, 107 }, { 80, 30 } }, INFO_FONT_SMALL, GTextAlignmentCenter, INFO_COLOR_CORNER, cachedWeather.city },
+    [INFO_TEMPERATURE] = { { { 60, 86 }, { 30, 21 } }, INFO_FONT_BOLD, GTextAlignmentCenter, INFO_COLOR_MAIN, cachedWeather.temperature }
 };
 
+static GFont s_info_fonts[INFO_FONTS];
+static bool s_weather_loading = false; // loading icon up, temperature hidden until the next record
+
+static void info_fonts_load(void) {
+    s_info_fonts[INFO_FONT_SMALL] = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+    s_info_fonts[INFO_FONT_BOLD] = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+}
+
+static void info_draw(GContext *ctx, uint8_t id) {
+    const InfoSlot *slot = &INFO_SLOT_TABLE[id];
+    if (slot->text[0] == '\0') {
+        return;
+    }
+    graphics_context_set_text_color(ctx, (slot->color == INFO_COLOR_MAIN) ? s_theme->maintext : s_theme->cornertext);
+    graphics_draw_text(ctx, slot->text, s_info_fonts[slot->font], slot->frame, GTextOverflowModeWordWrap, slot->alignment, NULL);
+}
+
+// the slot's buffer changed, redraw the layer that shows it
+static void info_changed(uint8_t id) {
+    compositor_invalidate();
+    layer_mark_dirty((id == INFO_TEMPERATURE) ? s_center_layer : s_info_layer);
+}
+
+// second hand frames only draw the slots the old second hand damaged
+static void info_update_proc(Layer *layer, GContext *ctx) {
+    STATS_INC(layers_drawn);
+    for (uint8_t id = 0; id < INFO_SLOTS; ++id) {
+        if ((id != INFO_TEMPERATURE) && (!s_compositor_partial || compositor_damaged(id))) {
+            info_draw(ctx, id);
+        }
+    }
+}
+
+
+//======================================
+// WEATHER ICONS
+//======================================
+// current weather on the center box, the loading icon while a request is out
+static void icon_update_proc(Layer *layer, GContext *ctx) {
+    GRect bounds = layer_get_bounds(layer);
+    STATS_INC(layers_drawn);
+    if (s_compositor_partial) {
+        return; // on the center box, which second hand frames keep
+    }
+    weather_icon_draw(ctx, bounds, s_weather_loading ? WEATHER_ICON_LOADING : cachedWeather.icon_current, &s_theme->icons);
+    STATS_ADD(pixels_written, bounds.size.w * bounds.size.h);
+}
+
+static void forecasticon_update_proc(Layer *layer, GContext *ctx) {
+    GRect bounds = layer_get_bounds(layer);
+    STATS_INC(layers_drawn);
+    if (s_compositor_partial && !compositor_damaged(COMPOSITOR_FORECASTICON)) {
+        return; // under the hands, same as the info text
+    }
+    weather_icon_draw(ctx, bounds, cachedWeather.forecasticon, &s_theme->icons);
+    STATS_ADD(pixels_written, bounds.size.w * bounds.size.h);
+}
+
+
 //======================================
 // REQUEST WEATHER USING PHONE
 //======================================
@@ -138,8 +468,6 @@ static const uint32_t WEATHER_ICONS_SMALL_REVERSE[] = {
 // someday I'll figure out how to do bidirectional syncing
 static void request_weather(void) {
 	DictionaryIterator *iter;
-    weather_fetched = true;
-    
 	app_message_outbox_begin(&iter);
 
 	if (!iter) {
@@ -151,49 +479,317 @@ static void request_weather(void) {
     dict_write_int(iter, 0, &value, sizeof(int), true);
     dict_write_end(iter);
     app_message_outbox_send();
+    TELEMETRY_COUNT(TELEMETRY_MESSAGES_OUT);
     
     // show loading icon
-    if (s_icon_bitmap) {
-        gbitmap_destroy(s_icon_bitmap);
+    s_weather_loading = true;
+    layer_mark_dirty(s_icon_layer);
+    info_changed(INFO_TEMPERATURE);}
+
+
+//======================================
+// WEATHER DISPLAY
+//======================================
+// last record applied, identical records from the phone are dropped early
+static uint8_t s_last_record[sizeof(WeatherRecord) + WEATHER_CITY_MAX];
+static uint16_t s_last_record_length = 0;
+
+// push the cached weather into the icon and text layers
+static void weather_show(void) {
+    compositor_invalidate();
+    layer_mark_dirty(s_icon_layer);
+    layer_mark_dirty(s_forecasticon_layer);
+    info_changed(INFO_TEMPERATURE);
+    info_changed(INFO_CITY); // the info layer redraws city, sun times, min-max and misc together
+}
+
+// only redraw when the slot's text changed
+static void weather_text_update(uint8_t id, const char *previous) {
+    if (strcmp(INFO_SLOT_TABLE[id].text, previous) == 0) {
+        STATS_INC(redraws_suppressed);
+        return;
+    }
+    info_changed(id);
+}
+
+// only touch the icons, labels and flash that changed since the previous weather
+static void weather_show_changed(const weatherdata *previous) {
+    compositor_invalidate();
+    if (cachedWeather.icon_current != previous->icon_current) {
+        layer_mark_dirty(s_icon_layer);
+    }
+    else {
+        STATS_INC(redraws_suppressed);
+    }
+    if (cachedWeather.forecasticon != previous->forecasticon) {
+        layer_mark_dirty(s_forecasticon_layer);
+    }
+    else {
+        STATS_INC(redraws_suppressed);
+    }
+    weather_text_update(INFO_TEMPERATURE, previous->temperature);
+    weather_text_update(INFO_CITY, previous->city);
+    weather_text_update(INFO_SUNTIMES, previous->suntimes);
+    weather_text_update(INFO_MINMAXTEMP, previous->minmaxtemp);
+    weather_text_update(INFO_MISC, previous->misc);
+
+    // weather cache goes to flash with the next storage flush
+    if (memcmp(previous, &cachedWeather, sizeof(cachedWeather)) != 0) {
+        storage_mark_dirty(&s_weather_store);
+    }
+    else {
+        STATS_INC(flash_writes_suppressed);
+    }
+}
+
+// local time of a UTC epoch, H:MM in 24 hour mode or H:MM AM/PM
+static size_t format_suntime(char *buffer, size_t size, time_t utc, bool clock24) {
+    struct tm *t = localtime(&utc);
+    return format_clock(buffer, size, t->tm_hour, t->tm_min, clock24);
+}
+
+// temperature, min-max and wind labels, temperatures in degrees of the record's unit
+static void weather_format_values(int temperature, int temp_min, int temp_max, int wind, bool imperial) {
+    format_temperature(cachedWeather.temperature, sizeof(cachedWeather.temperature), temperature);
+
+    size_t length = format_int(cachedWeather.minmaxtemp, sizeof(cachedWeather.minmaxtemp), temp_min);
+    length += format_text(cachedWeather.minmaxtemp + length, sizeof(cachedWeather.minmaxtemp) - length, "-");
+    format_temperature(cachedWeather.minmaxtemp + length, sizeof(cachedWeather.minmaxtemp) - length, temp_max);
+
+    length = format_int(cachedWeather.misc, sizeof(cachedWeather.misc), wind);
+    format_text(cachedWeather.misc + length, sizeof(cachedWeather.misc) - length, imperial ? " mph" : " km/h");
+}
+
+// sunrise and sunset for today at the last known position, in the watch's 12/24h style
+static void suntimes_update(void) {
+    time_t sunrise, sunset;
+    if (cachedWeather.latitude == SUNTIMES_NO_LOCATION) {
+        cachedWeather.suntimes[0] = '\0';
+    }
+    else if (!suntimes_compute(time_start_of_today(), cachedWeather.latitude, cachedWeather.longitude, &sunrise, &sunset)) {
+        format_text(cachedWeather.suntimes, sizeof(cachedWeather.suntimes), "--\n--"); // polar day or night
+    }
+    else {
+        size_t size = sizeof(cachedWeather.suntimes);
+        size_t length = format_suntime(cachedWeather.suntimes, size, sunrise, clock_is_24h_style());
+        length += format_text(cachedWeather.suntimes + length, size - length, "\n");
+        format_suntime(cachedWeather.suntimes + length, size - length, sunset, clock_is_24h_style());
     }
-    if (settings.reverse == 1) {
-        s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_REVERSE[3]);
+}
+
+// unpack a weather record from the phone into the display strings
+static void weather_record_apply(const uint8_t *data, uint16_t length) {
+    const WeatherRecord *record = (const WeatherRecord *)data;
+    if ((length < sizeof(WeatherRecord)) || (record->version != WEATHER_RECORD_VERSION)) {
+        return; // empty initial tuple or a record from a newer phone app
+    }
+    if (s_weather_loading) {
+        s_weather_loading = false; // take the loading icon down even if the record is a repeat
+        weather_show();
+    }
+    if ((length == s_last_record_length) && (memcmp(data, s_last_record, length) == 0)) {
+        STATS_INC(messages_suppressed);
+        return;
+    }
+    s_last_record_length = (length < sizeof(s_last_record)) ? length : sizeof(s_last_record);
+    memcpy(s_last_record, data, s_last_record_length);
+
+    weatherdata previous = cachedWeather;
+    bool imperial = record->flags & WEATHER_FLAG_IMPERIAL;
+    cachedWeather.icon_current = record->icon;
+    cachedWeather.forecasticon = record->forecasticon;
+
+    if (record->flags & (WEATHER_FLAG_NO_DATA | WEATHER_FLAG_NO_GPS)) {
+        format_text(cachedWeather.temperature, sizeof(cachedWeather.temperature),
+                    (record->flags & WEATHER_FLAG_NO_GPS) ? "GPS" : "");
+        cachedWeather.minmaxtemp[0] = '\0';
+        cachedWeather.suntimes[0] = '\0';
+        cachedWeather.misc[0] = '\0';
     }
     else {
-        s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS[3]);
+        weather_format_values(record->temperature, record->temp_min, record->temp_max, record->wind, imperial);
+        cachedWeather.latitude = record->latitude;
+        cachedWeather.longitude = record->longitude;
+        suntimes_update();
+    }
+
+    // city name is length prefixed, clip it to the record and the buffer
+    size_t city_length = record->city_length;
+    if (city_length > length - sizeof(WeatherRecord)) {
+        city_length = length - sizeof(WeatherRecord);
+    }
+    if (city_length > sizeof(cachedWeather.city) - 1) {
+        city_length = sizeof(cachedWeather.city) - 1;
     }
-    bitmap_layer_set_bitmap(s_icon_layer, s_icon_bitmap);
-    text_layer_set_text(s_temperature_label, "");}
+    memcpy(cachedWeather.city, record->city, city_length);
+    cachedWeather.city[city_length] = '\0';
+
+    // slots in the other units, for another place or for a place without data are no use any more,
+    // stepping through them would put the old forecast over these labels
+    // the phone sends the record ahead of the timeline, so a new place's timeline is kept
+    bool no_data = record->flags & (WEATHER_FLAG_NO_DATA | WEATHER_FLAG_NO_GPS);
+    bool moved = (strcmp(cachedWeather.city, previous.city) != 0) ||
+                 (cachedWeather.latitude != previous.latitude) || (cachedWeather.longitude != previous.longitude);
+    if ((s_timeline.count > 0) && (no_data || moved || ((s_timeline.flags ^ record->flags) & WEATHER_FLAG_IMPERIAL))) {
+        s_timeline.count = 0;
+        s_timeline_shown = -1;
+        storage_mark_dirty(&s_timeline_store);
+    }
+
+    weather_show_changed(&previous);
+}
 
 
 //======================================
-// HEALTH UPDATER
+// WEATHER TIMELINE
 //======================================
-// get total steps for the day
-#if defined(PBL_HEALTH)
-static void request_health() {
-    time_t start = time_start_of_today();
-    time_t end = time(NULL);
-    HealthMetric metric;
-    
-    if (settings.distance == 1) { // show distance walked
-        metric = HealthMetricWalkedDistanceMeters;
+// slot covering now, -1 before the first slot or after the last one
+static int weather_timeline_slot(time_t now) {
+    if ((s_timeline.count == 0) || (s_timeline.step == 0) || (now < (time_t)s_timeline.start)) {
+        return -1;
     }
-    else { // show no. of steps walked
-        metric = HealthMetricStepCount;
+    int slot = (now - s_timeline.start) / (s_timeline.step * 60);
+    return (slot < s_timeline.count) ? slot : -1;
+}
+
+// slots from now to the end of the timeline
+static int weather_timeline_left(time_t now) {
+    if ((s_timeline.count > 0) && (now < (time_t)s_timeline.start)) {
+        return s_timeline.count;
     }
-    
-    // Check the metric has data available for today
-    HealthServiceAccessibilityMask mask = health_service_metric_accessible(metric, start, end);
-    
-    if (mask & HealthServiceAccessibilityMaskAvailable) {
-        if (settings.distance == 1) { // show distance walked
-            snprintf(s_fitness_buffer, sizeof(s_fitness_buffer), "%d m", (int)health_service_sum_today(metric));
+    int slot = weather_timeline_slot(now);
+    return (slot < 0) ? 0 : s_timeline.count - slot;
+}
+
+// a new timeline from the phone, the labels keep the live record until the next slot starts
+static void weather_timeline_apply(const uint8_t *data, uint16_t length) {
+    const WeatherTimeline *timeline = (const WeatherTimeline *)data;
+    size_t header = offsetof(WeatherTimeline, slots);
+    if ((length < header) || (timeline->version != WEATHER_TIMELINE_VERSION)) {
+        return; // empty initial tuple or a timeline from a newer phone app
+    }
+    uint8_t count = timeline->count;
+    if (count > WEATHER_TIMELINE_SLOTS) {
+        count = WEATHER_TIMELINE_SLOTS;
+    }
+    if (length < header + count * sizeof(WeatherSlot)) {
+        return;
+    }
+    if ((memcmp(&s_timeline, data, header + count * sizeof(WeatherSlot)) == 0) && (s_timeline.count == count)) {
+        STATS_INC(messages_suppressed);
+        return;
+    }
+
+    memset(&s_timeline, 0, sizeof(s_timeline));
+    memcpy(&s_timeline, data, header + count * sizeof(WeatherSlot));
+    s_timeline.count = count;
+    storage_mark_dirty(&s_timeline_store);
+    s_timeline_shown = weather_timeline_slot(time(NULL));
+}
+
+// step the labels to the slot for now, nothing to do until a new slot starts
+static void weather_timeline_advance(void) {
+    int slot = weather_timeline_slot(time(NULL));
+    if ((slot < 0) || (slot == s_timeline_shown)) {
+        return;
+    }
+    s_timeline_shown = slot;
+
+    const WeatherSlot *now = &s_timeline.slots[slot];
+    int8_t temp_min = now->temperature, temp_max = now->temperature;
+    for (int i = slot + 1; (i < s_timeline.count) && (i < slot + WEATHER_TIMELINE_MINMAX_SLOTS); ++i) {
+        if (s_timeline.slots[i].temperature < temp_min) {
+            temp_min = s_timeline.slots[i].temperature;
         }
-        else { // show no. of steps walked
-            snprintf(s_fitness_buffer, sizeof(s_fitness_buffer), "%dx", (int)health_service_sum_today(metric));
+        if (s_timeline.slots[i].temperature > temp_max) {
+            temp_max = s_timeline.slots[i].temperature;
         }
-        text_layer_set_text(s_fitness_label, s_fitness_buffer);
+    }
+
+    weatherdata previous = cachedWeather;
+    bool imperial = s_timeline.flags & WEATHER_FLAG_IMPERIAL;
+    cachedWeather.icon_current = now->icon;
+    if (slot + 1 < s_timeline.count) {
+        cachedWeather.forecasticon = s_timeline.slots[slot + 1].icon;
+    }
+    weather_format_values(now->temperature, temp_min, temp_max, now->wind, imperial);
+    weather_show_changed(&previous);
+}
+
+
+//======================================
+// HEALTH UPDATER
+//======================================
+// running totals for today, kept current by health events instead of polling
+// both units are kept so switching between them needs no new query
+#if defined(PBL_HEALTH)
+static bool s_health_steps_available = false, s_health_distance_available = false;
+static HealthValue s_health_steps = -1, s_health_distance = -1; // -1 until known
+static HealthValue s_health_shown = -1; // what the label says now
+static uint8_t s_health_shown_distance = 0xFF; // unit the label says it in
+static bool s_health_moved = false; // movement since the totals were last read
+
+// show the total for the selected unit, label only touched if the text would change
+static void health_show(void) {
+    HealthValue value = (settings.distance == 1) ? s_health_distance : s_health_steps;
+    if (value < 0) {
+        return;
+    }
+    if ((value == s_health_shown) && (settings.distance == s_health_shown_distance)) {
+        STATS_INC(redraws_suppressed);
+        return;
+    }
+    s_health_shown = value;
+    s_health_shown_distance = settings.distance;
+
+    // distance walked or no. of steps walked
+    format_fitness(s_fitness_buffer, sizeof(s_fitness_buffer), value, settings.distance == 1);
+    info_changed(INFO_FITNESS);
+}
+
+static HealthValue health_sum(HealthMetric metric, bool available) {
+    if (!available) {
+        return -1;
+    }
+    STATS_INC(health_queries);
+    return health_service_sum_today(metric);
+}
+
+// read today's totals, distance only moves when steps do
+static void health_read(bool force) {
+    s_health_moved = false;
+    HealthValue steps = health_sum(HealthMetricStepCount, s_health_steps_available);
+    if (!force && (steps == s_health_steps)) {
+        return;
+    }
+    s_health_steps = steps;
+    s_health_distance = health_sum(HealthMetricWalkedDistanceMeters, s_health_distance_available);
+    health_show();
+}
+
+// significant updates (subscribing, midnight) recheck what data exists today and read the totals
+// movement updates come every few steps while walking, they only note that the totals moved
+static void handle_health(HealthEventType event, void *context) {
+    if (event == HealthEventMovementUpdate) {
+        s_health_moved = true;
+        return;
+    }
+    if (event != HealthEventSignificantUpdate) {
+        return;
+    }
+    time_t start = time_start_of_today();
+    time_t end = time(NULL);
+    s_health_steps_available = health_service_metric_accessible(HealthMetricStepCount, start, end) & HealthServiceAccessibilityMaskAvailable;
+    s_health_distance_available = health_service_metric_accessible(HealthMetricWalkedDistanceMeters, start, end) & HealthServiceAccessibilityMaskAvailable;
+    STATS_INC(health_queries);
+    STATS_INC(health_queries);
+    health_read(true);
+}
+
+// from the minute tick, so walking costs at most one read a minute
+static void health_tick(void) {
+    if (s_health_moved) {
+        health_read(false);
     }
 }
 #endif
@@ -204,177 +800,652 @@ static void request_health() {
 //======================================
 // white on black default, black on white reverse
 // blue or red theme for ticks and center box
+// a theme is one row of this table, indexed by reverse << 1 | bluetheme
+#define THEME_COLOR(color, bw) { .argb = COLOR_FALLBACK(color##ARGB8, bw##ARGB8) }
+
+static const ThemePalette THEMES[] = {
+    { // red theme on black
+        .background = THEME_COLOR(GColorBlack, GColorBlack),
+        .ticks = THEME_COLOR(GColorRed, GColorWhite),
+        .maintext = THEME_COLOR(GColorChromeYellow, GColorWhite), // for numerals, date, weather
+        .cornertext = THEME_COLOR(GColorWhite, GColorWhite), // for battery, BT, misc, misc2
+        .second = THEME_COLOR(GColorChromeYellow, GColorWhite),
+        .hand_fill = THEME_COLOR(GColorWhite, GColorWhite),
+        .hand_stroke = THEME_COLOR(GColorBlack, GColorBlack),
+        .center_fill = THEME_COLOR(GColorBlack, GColorBlack),
+        .center_stroke = THEME_COLOR(GColorRed, GColorWhite),
+        .icons = {
+            .sun = THEME_COLOR(GColorPastelYellow, GColorWhite),
+            .cloud = THEME_COLOR(GColorWhite, GColorWhite),
+            .accent = THEME_COLOR(GColorElectricBlue, GColorWhite)
+        }
+    },
+    { // blue theme on black
+        .background = THEME_COLOR(GColorBlack, GColorBlack),
+        .ticks = THEME_COLOR(GColorVividCerulean, GColorWhite),
+        .maintext = THEME_COLOR(GColorChromeYellow, GColorWhite),
+        .cornertext = THEME_COLOR(GColorWhite, GColorWhite),
+        .second = THEME_COLOR(GColorChromeYellow, GColorWhite),
+        .hand_fill = THEME_COLOR(GColorWhite, GColorWhite),
+        .hand_stroke = THEME_COLOR(GColorBlack, GColorBlack),
+        .center_fill = THEME_COLOR(GColorBlack, GColorBlack),
+        .center_stroke = THEME_COLOR(GColorVividCerulean, GColorWhite),
+        .icons = {
+            .sun = THEME_COLOR(GColorPastelYellow, GColorWhite),
+            .cloud = THEME_COLOR(GColorWhite, GColorWhite),
+            .accent = THEME_COLOR(GColorElectricBlue, GColorWhite)
+        }
+    },
+    { // red theme on reverse
+        .background = THEME_COLOR(GColorWhite, GColorWhite),
+        .ticks = THEME_COLOR(GColorRed, GColorBlack),
+        .maintext = THEME_COLOR(GColorBlack, GColorBlack),
+        .cornertext = THEME_COLOR(GColorBlack, GColorBlack),
+        .second = THEME_COLOR(GColorDarkGray, GColorBlack),
+        .hand_fill = THEME_COLOR(GColorRed, GColorBlack),
+        .hand_stroke = THEME_COLOR(GColorWhite, GColorWhite),
+        .center_fill = THEME_COLOR(GColorWhite, GColorWhite),
+        .center_stroke = THEME_COLOR(GColorRed, GColorBlack),
+        .icons = {
+            .sun = THEME_COLOR(GColorOrange, GColorBlack),
+            .cloud = THEME_COLOR(GColorBlack, GColorBlack),
+            .accent = THEME_COLOR(GColorDukeBlue, GColorBlack)
+        }
+    },
+    { // blue theme on reverse
+        .background = THEME_COLOR(GColorWhite, GColorWhite),
+        .ticks = THEME_COLOR(GColorBlueMoon, GColorBlack),
+        .maintext = THEME_COLOR(GColorBlack, GColorBlack),
+        .cornertext = THEME_COLOR(GColorBlack, GColorBlack),
+        .second = THEME_COLOR(GColorDarkGray, GColorBlack),
+        .hand_fill = THEME_COLOR(GColorBlue, GColorBlack),
+        .hand_stroke = THEME_COLOR(GColorWhite, GColorWhite),
+        .center_fill = THEME_COLOR(GColorWhite, GColorWhite),
+        .center_stroke = THEME_COLOR(GColorBlueMoon, GColorBlack),
+        .icons = {
+            .sun = THEME_COLOR(GColorOrange, GColorBlack),
+            .cloud = THEME_COLOR(GColorBlack, GColorBlack),
+            .accent = THEME_COLOR(GColorDukeBlue, GColorBlack)
+        }
+    }
+};
+
+// switching theme is a pointer swap, the procs read the palette when they draw
 static void color_handler() {
-    if (settings.reverse == 1) { // reverse layout
-        color_background = GColorWhite;
-        color_center_fill = COLOR_FALLBACK(GColorWhite, GColorWhite);
-//        color_center_stroke = COLOR_FALLBACK(GColorBlue, GColorBlack);
-//        color_ticks = COLOR_FALLBACK(GColorBlue, GColorBlack);
-        color_second = COLOR_FALLBACK(GColorDarkGray, GColorBlack);
-//        color_hand_fill = COLOR_FALLBACK(GColorBlack, GColorBlack);;
-        color_hand_stroke = COLOR_FALLBACK(GColorWhite, GColorWhite);
-        color_maintext = COLOR_FALLBACK(GColorBlack, GColorBlack); // for numerals, date, weather
-        color_cornertext = COLOR_FALLBACK(GColorBlack, GColorBlack); // for battery, BT, misc, misc2
-        color_maintextbackground = COLOR_FALLBACK(GColorClear, GColorClear); // background for main text
-        color_cornertextbackground = COLOR_FALLBACK(GColorClear, GColorClear); // background for corner text
-        
-        if (settings.bluetheme == 1) { // blue theme on reverse
-            color_hand_fill = COLOR_FALLBACK(GColorBlue, GColorBlack);;
-            color_center_stroke = COLOR_FALLBACK(GColorBlueMoon, GColorBlack);
-            color_ticks = COLOR_FALLBACK(GColorBlueMoon, GColorBlack);
-        }
-        else { // red theme on reverse
-            color_hand_fill = COLOR_FALLBACK(GColorRed, GColorBlack);;
-            color_center_stroke = COLOR_FALLBACK(GColorRed, GColorBlack);
-            color_ticks = COLOR_FALLBACK(GColorRed, GColorBlack);
-        }
-    }
-    else { // default black background
-        color_background = GColorBlack;
-        color_center_fill = COLOR_FALLBACK(GColorBlack, GColorBlack);
-//        color_center_stroke = COLOR_FALLBACK(GColorRed, GColorWhite);
-//        color_ticks = COLOR_FALLBACK(GColorRed, GColorWhite);
-        color_second = COLOR_FALLBACK(GColorChromeYellow, GColorWhite);
-//        color_hand_fill = COLOR_FALLBACK(GColorWhite, GColorWhite);;
-        color_hand_stroke = COLOR_FALLBACK(GColorBlack, GColorBlack);
-        color_maintext = COLOR_FALLBACK(GColorChromeYellow, GColorWhite); // for numerals, date, weather
-        color_cornertext = COLOR_FALLBACK(GColorWhite, GColorWhite); // for battery, BT, misc, misc2
-        color_maintextbackground = COLOR_FALLBACK(GColorClear, GColorClear); // background for main text
-        color_cornertextbackground = COLOR_FALLBACK(GColorClear, GColorClear); // background for corner text
-        
-        if (settings.bluetheme == 1) { // blue theme on black
-            color_hand_fill = COLOR_FALLBACK(GColorWhite, GColorWhite);;
-            color_center_stroke = COLOR_FALLBACK(GColorVividCerulean, GColorWhite);
-            color_ticks = COLOR_FALLBACK(GColorVividCerulean, GColorWhite);
-        }
-        else { // red theme on black
-            color_hand_fill = COLOR_FALLBACK(GColorWhite, GColorWhite);;
-            color_center_stroke = COLOR_FALLBACK(GColorRed, GColorWhite);
-            color_ticks = COLOR_FALLBACK(GColorRed, GColorWhite);
+    uint8_t theme = ((settings.reverse == 1) << 1) | (settings.bluetheme == 1);
+    if (theme >= ARRAY_LENGTH(THEMES)) {
+        theme = 0;
+    }
+    s_theme = &THEMES[theme];
+    compositor_invalidate();
+
+    // dial has to be drawn again with the new colors
+    s_dial_cache_valid = false;
+}
+
+// live theme change from the config page
+static void theme_switch(void) {
+    color_handler();
+
+    // background, text, icons, hands and center box pick up the new colors
+    layer_mark_dirty(window_get_root_layer(window));
+}
+
+
+//======================================
+// DIAL CACHE
+//======================================
+// bytes of a row that hold pixels, 0 for formats whose rows aren't plain byte runs,
+// like the round frame buffer, those can't be copied row by row
+static uint16_t dial_cache_row_bytes(const GBitmap *bitmap) {
+    GSize size = gbitmap_get_bounds(bitmap).size;
+    switch (gbitmap_get_format(bitmap)) {
+        case GBitmapFormat8Bit:
+            return size.w;
+        case GBitmapFormat1Bit:
+            return (size.w + 7) / 8;
+        default:
+            return 0;
+    }
+}
+
+// the cache holds the frame buffer row for row, same format and size
+// storing makes a new cache when the frame buffer differs from the one window_load guessed
+static bool dial_cache_fits(const GBitmap *fb, bool store) {
+    GRect fb_bounds = gbitmap_get_bounds(fb), cache_bounds = gbitmap_get_bounds(s_dial_cache);
+    uint16_t row_bytes = dial_cache_row_bytes(fb);
+    if (row_bytes == 0) {
+        return false;
+    }
+    if ((gbitmap_get_format(s_dial_cache) != gbitmap_get_format(fb)) || !grect_equal(&fb_bounds, &cache_bounds)) {
+        if (!store) {
+            return false;
         }
+        gbitmap_destroy(s_dial_cache);
+        s_dial_cache = gbitmap_create_blank(fb_bounds.size, gbitmap_get_format(fb));
+        if (!s_dial_cache) {
+            return false;
+        }
+    }
+    return (gbitmap_get_bytes_per_row(fb) >= row_bytes) && (gbitmap_get_bytes_per_row(s_dial_cache) >= row_bytes);
+}
 
+// copy the whole frame buffer into the dial cache or back again
+// returns false if the frame buffer can't be captured or doesn't fit the cache
+static bool dial_cache_copy(GContext *ctx, bool store) {
+    GBitmap *fb = graphics_capture_frame_buffer(ctx);
+    if (!fb) {
+        return false;
+    }
+    if (!dial_cache_fits(fb, store)) {
+        graphics_release_frame_buffer(ctx, fb);
+        return false;
     }
 
+    uint8_t *fb_data = gbitmap_get_data(fb);
+    uint8_t *cache_data = gbitmap_get_data(s_dial_cache);
+    uint16_t fb_stride = gbitmap_get_bytes_per_row(fb);
+    uint16_t cache_stride = gbitmap_get_bytes_per_row(s_dial_cache);
+    uint16_t row_bytes = dial_cache_row_bytes(fb);
+    int16_t rows = gbitmap_get_bounds(s_dial_cache).size.h;
+
+    for (int16_t y = 0; y < rows; ++y) {
+        if (store) {
+            memcpy(cache_data + y * cache_stride, fb_data + y * fb_stride, row_bytes);
+        }
+        else {
+            memcpy(fb_data + y * fb_stride, cache_data + y * cache_stride, row_bytes);
+        }
+    }
+
+    graphics_release_frame_buffer(ctx, fb);
+    return true;
 }
 
 
 //======================================
 // BACKGROUND UPDATER
 //======================================
-static void bg_update_proc(Layer *layer, GContext *ctx) {
-    graphics_context_set_fill_color(ctx, color_background);
-    graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
-    graphics_context_set_fill_color(ctx, color_ticks);
-    graphics_context_set_stroke_color(ctx, color_ticks);
+// full dial drawing, only needed when the cache is empty or stale
+static void draw_dial(Layer *layer, GContext *ctx) {
+    GRect bounds = layer_get_bounds(layer);
+
+    graphics_context_set_fill_color(ctx, s_theme->background);
+    graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+    graphics_context_set_fill_color(ctx, s_theme->ticks);
+    graphics_context_set_stroke_color(ctx, s_theme->ticks);
     for (int i = 0; i < NUM_CLOCK_TICKS; ++i) {
         gpath_draw_filled(ctx, s_tick_paths[i]);
     }
+
+    // numerals for 12, 4, 8 o'clock
+    graphics_context_set_text_color(ctx, s_theme->maintext);
+    graphics_draw_text(ctx, "12", custom_font_numerals, GRect(bounds.size.w / 2 - 25, -9, 50, 45),
+                       GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+    graphics_draw_text(ctx, "4", custom_font_numerals, GRect(112, 100, 30, 40),
+                       GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
+    graphics_draw_text(ctx, "8", custom_font_numerals, GRect(2, 100, 30, 40),
+                       GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
+}
+
+// blit the cached dial, rebuilding the cache first if the theme changed
+static void bg_update_proc(Layer *layer, GContext *ctx) {
+    STATS_INC(layers_drawn);
+    TELEMETRY_BEGIN(telemetry_start);
+    #if DEBUG_PROFILE
+    uint32_t start = profile_time_ms();
+    #endif
+
+    // second hand frames only put back the dial under the old second hand
+    // and under whatever it crossed, which the layers above draw again
+    if (s_compositor_partial && s_dial_cache_valid) {
+        GBitmap *fb = graphics_capture_frame_buffer(ctx);
+        if (fb) {
+            STATS_ADD(pixels_written, hand_raster_copy_rows(fb, s_dial_cache, &s_second_rows));
+            for (uint8_t item = 0; item < COMPOSITOR_ITEMS; ++item) {
+                if (compositor_damaged(item)) {
+                    hand_raster_rows_rect(s_compositor_damage_frame[item], &s_damage_rows);
+                    STATS_ADD(pixels_written, hand_raster_copy_rows(fb, s_dial_cache, &s_damage_rows));
+                }
+            }
+            graphics_release_frame_buffer(ctx, fb);
+            TELEMETRY_END(TELEMETRY_BG, telemetry_start);
+            return;
+        }
+    }
+    compositor_invalidate();
+
+    #if DEBUG_PROFILE
+    GRect bounds = layer_get_bounds(layer);
+    s_stats.pixels_written += bounds.size.w * bounds.size.h;
+    #endif
+    if (s_dial_cache && s_dial_cache_valid && dial_cache_copy(ctx, false)) {
+        #if DEBUG_PROFILE
+        s_stats.dial_blits++;
+        s_stats.dial_blit_ms += profile_time_ms() - start;
+        #endif
+        TELEMETRY_END(TELEMETRY_BG, telemetry_start);
+        return;
+    }
+
+    draw_dial(layer, ctx);
+    if (s_dial_cache) {
+        s_dial_cache_valid = dial_cache_copy(ctx, true);
+    }
+    #if DEBUG_PROFILE
+    s_stats.dial_renders++;
+    s_stats.dial_render_ms += profile_time_ms() - start;
+    #endif
+    TELEMETRY_END(TELEMETRY_BG, telemetry_start);
+}
+
+
+//======================================
+// HAND POSES
+//======================================
+// copy a precomputed pose into a hand path, no rotation needed
+static void hand_pose_load(GPath *path, const int8_t (*pose)[2]) {
+    for (uint32_t i = 0; i < path->num_points; ++i) {
+        path->points[i].x = pose[i][0];
+        path->points[i].y = pose[i][1];
+    }
 }
 
 
 //======================================
 // HANDS UPDATER
 //======================================
-// draw second hand if config_seconds set to 1
-// otherwise minute and hour hands only
-static void hands_update_proc(Layer *layer, GContext *ctx) {
-	GRect bounds = layer_get_bounds(layer);
-	time_t now = time(NULL);
-	struct tm *t = localtime(&now);
-	
+// minute and hour hands with GPath, used when the frame buffer can't be captured
+// or has a layout the rasterizer doesn't write, see hand_raster_supported
+static void hands_draw_gpath(GContext *ctx, const struct tm *t) {
 	// minute hand
-	graphics_context_set_fill_color(ctx, color_hand_fill);
-	graphics_context_set_stroke_color(ctx, color_hand_stroke);
-	gpath_rotate_to(s_minute_arrow, TRIG_MAX_ANGLE * t->tm_min / 60);
+	graphics_context_set_fill_color(ctx, s_theme->hand_fill);
+	graphics_context_set_stroke_color(ctx, s_theme->hand_stroke);
+	hand_pose_load(s_minute_arrow, MINUTE_HAND_POSE[t->tm_min]);
 	gpath_draw_filled(ctx, s_minute_arrow);
 	gpath_draw_outline(ctx, s_minute_arrow);
 
-	// hour hand
-	graphics_context_set_fill_color(ctx, color_hand_fill);
-	graphics_context_set_stroke_color(ctx, color_hand_stroke);
-	gpath_rotate_to(s_hour_arrow, (TRIG_MAX_ANGLE * (((t->tm_hour % 12) * 6) + (t->tm_min / 10))) / (12 * 6)); // from Pebble SDK example
+	// hour hand, moves every 5 minutes
+	graphics_context_set_fill_color(ctx, s_theme->hand_fill);
+	graphics_context_set_stroke_color(ctx, s_theme->hand_stroke);
+	hand_pose_load(s_hour_arrow, HOUR_HAND_POSE[((t->tm_hour % 12) * 12) + (t->tm_min / 5)]);
 	gpath_draw_filled(ctx, s_hour_arrow);
 	gpath_draw_outline(ctx, s_hour_arrow);
-    
-    // draw second hand if config is set
-    if (settings.seconds == 1) {
-        GPoint center = grect_center_point(&bounds);
-        int16_t second_hand_length = bounds.size.h / 2;
-        int32_t second_angle = TRIG_MAX_ANGLE * t->tm_sec / 60;
-        GPoint second_hand = {
-            .x = (int16_t)(sin_lookup(second_angle) * (int32_t)second_hand_length / TRIG_MAX_RATIO) + center.x,
-            .y = (int16_t)(-cos_lookup(second_angle) * (int32_t)second_hand_length / TRIG_MAX_RATIO) + center.y,
-        };
-        #ifdef PBL_PLATFORM_BASALT
-                graphics_context_set_stroke_width(ctx, 2);
-        #endif
-        graphics_context_set_stroke_color(ctx, color_second);
-        graphics_draw_line(ctx, second_hand, center);
+}
+
+// minute and hour hands filled and outlined in one pass over the frame buffer rows
+// clip limits them to the pixels the compositor restored, NULL draws them whole
+static bool hands_draw_raster(GContext *ctx, GPoint center, const struct tm *t, const HandRasterRows *clip) {
+    GBitmap *fb = graphics_capture_frame_buffer(ctx);
+    if (!fb) {
+        return false;
+    }
+    if (!hand_raster_supported(fb)) {
+        graphics_release_frame_buffer(ctx, fb);
+        return false;
     }
+    STATS_ADD(pixels_written, hand_raster_polygon(fb, center, MINUTE_HAND_POSE[t->tm_min], MINUTE_HAND_POSE_POINTS,
+                                                  s_theme->hand_fill, s_theme->hand_stroke, clip));
+    STATS_ADD(pixels_written, hand_raster_polygon(fb, center, HOUR_HAND_POSE[((t->tm_hour % 12) * 12) + (t->tm_min / 5)],
+                                                  HOUR_HAND_POSE_POINTS, s_theme->hand_fill, s_theme->hand_stroke, clip));
+    graphics_release_frame_buffer(ctx, fb);
+    return true;
+}
 
-	// rectangle in the middle for weather data
+// minute and hour hands, redrawn once a minute
+static void hands_update_proc(Layer *layer, GContext *ctx) {
+	TELEMETRY_BEGIN(telemetry_start);
+	GRect bounds = layer_get_bounds(layer);
+	GPoint center = grect_center_point(&bounds);
+	STATS_INC(layers_drawn);
+	if (!hands_draw_raster(ctx, center, &s_frame_time, s_compositor_partial ? &s_second_rows : NULL)) {
+		hands_draw_gpath(ctx, &s_frame_time);
+		TELEMETRY_END(TELEMETRY_HANDS, telemetry_start);
+		return;
+	}
+
+	// and over the frames the compositor put back, their text is under the hands
+	for (uint8_t item = 0; item < COMPOSITOR_ITEMS; ++item) {
+		if (compositor_damaged(item)) {
+			hand_raster_rows_rect(s_compositor_damage_frame[item], &s_damage_rows);
+			hands_draw_raster(ctx, center, &s_frame_time, &s_damage_rows);
+		}
+	}
+	TELEMETRY_END(TELEMETRY_HANDS, telemetry_start);
+}
+
+
+//======================================
+// CENTER BOX
+//======================================
+#define CENTER_BOX_RADIUS 9
+
+// rounded box in the middle for the weather icon and temperature
+static GRect center_box(GRect bounds) {
+    return GRect(bounds.size.w / 2 - 19, bounds.size.h / 2 - 24, 38, 49);
+}
+
+
+//======================================
+// SECOND HAND UPDATER
+//======================================
+// with a seconds window the hand only shows while a tap keeps the window open
+static bool s_seconds_window_open = false;
+// the last second hand went through the rasterizer, so s_second_rows are its pixels
+static bool s_second_rows_drawn = false;
+
+#ifdef PBL_PLATFORM_BASALT
+#define SECOND_HAND_WIDTH 2
+#else
+#define SECOND_HAND_WIDTH 1
+#endif
+
+static bool seconds_visible(void) {
+    return (settings.seconds == 1) && (s_power_stage < POWER_SAVE) && ((settings.secondswindow == 0) || s_seconds_window_open);
+}
+
+// draw second hand if config_seconds set to 1, redrawn every second
+// the part within the center box is never drawn, so the compositor never has to restore it
+// and the box can stay as it is, that leaves out a pixel or two in its rounded corners
+static void seconds_update_proc(Layer *layer, GContext *ctx) {
+    STATS_INC(layers_drawn);
+    s_second_rows_drawn = false;
+    if (!seconds_visible()) {
+        s_second_rows.count = 0;
+        return;
+    }
+
+	GRect bounds = layer_get_bounds(layer);
+	const struct tm *t = &s_frame_time;
+    GPoint center = grect_center_point(&bounds);
+    GPoint second_hand = {
+        .x = center.x + SECOND_HAND_POSE[t->tm_sec % SECOND_HAND_POSES][0],
+        .y = center.y + SECOND_HAND_POSE[t->tm_sec % SECOND_HAND_POSES][1],
+    };
+    hand_raster_line_rows(second_hand, center, SECOND_HAND_WIDTH, &s_second_rows);
+    hand_raster_rows_exclude(&s_second_rows, center_box(bounds));
+    GBitmap *fb = graphics_capture_frame_buffer(ctx);
+    if (fb && hand_raster_supported(fb)) {
+        STATS_ADD(pixels_written, hand_raster_fill_rows(fb, &s_second_rows, s_theme->second));
+        graphics_release_frame_buffer(ctx, fb);
+        s_second_rows_drawn = true;
+        return;
+    }
+    if (fb) {
+        graphics_release_frame_buffer(ctx, fb);
+    }
     #ifdef PBL_PLATFORM_BASALT
-        graphics_context_set_stroke_width(ctx, 2);
+            graphics_context_set_stroke_width(ctx, SECOND_HAND_WIDTH);
     #endif
-	graphics_context_set_fill_color(ctx, color_center_fill);
-	graphics_context_set_stroke_color(ctx, color_center_stroke);
-	graphics_fill_rect(ctx, GRect(bounds.size.w / 2 - 19, bounds.size.h / 2 - 24, 38, 49), 9, GCornersAll);
-	graphics_draw_round_rect(ctx, GRect(bounds.size.w / 2 - 19, bounds.size.h / 2 - 24, 38, 49), 9);
+    graphics_context_set_stroke_color(ctx, s_theme->second);
+    graphics_draw_line(ctx, second_hand, center);
+}
 
-    // update weather with phone every 01st and 31st minutes, but phone fetches fresh online data only every hour
-    // reset update status at 59 minutes
-    //	if((t->tm_min == 1) && (t->tm_sec == 0)) {
-    if((t->tm_min == 1) && (weather_fetched == false)) {
-        if (bluetooth_enabled == true) {
-            request_weather();
-            weather_fetched = true;
-        }
+
+//======================================
+// CENTER BOX UPDATER
+//======================================
+// rectangle in the middle for weather data, drawn above all hands
+// second hand frames keep the box from the last frame, unless a damaged frame overlapped it
+static void center_update_proc(Layer *layer, GContext *ctx) {
+	GRect bounds = layer_get_bounds(layer);
+	GRect box = center_box(bounds);
+    STATS_INC(layers_drawn);
+    if (s_compositor_partial && !compositor_damaged(COMPOSITOR_CENTER_BOX)) {
+        compositor_invalidate(); // last of the procs, the next frame is full unless a tick says otherwise
+        return;
     }
+    compositor_invalidate();
+    #ifdef PBL_PLATFORM_BASALT
+        graphics_context_set_stroke_width(ctx, 2);
+    #endif
+	graphics_context_set_fill_color(ctx, s_theme->center_fill);
+	graphics_context_set_stroke_color(ctx, s_theme->center_stroke);
+	graphics_fill_rect(ctx, box, CENTER_BOX_RADIUS, GCornersAll);
+	graphics_draw_round_rect(ctx, box, CENTER_BOX_RADIUS);
+	STATS_ADD(pixels_written, box.size.w * box.size.h);
+
+	// current temperature sits on the box
+	if (!s_weather_loading) {
+	    info_draw(ctx, INFO_TEMPERATURE);
+	}
+}
 
-    // update fitness data with phone every 5 minutes
-    #if defined(PBL_HEALTH)
-    if(t->tm_min % 4 == 0) {
-        health_fetched = false;
+//======================================
+// SCHEDULED JOBS
+//======================================
+// weather from the phone at minute 1 of every hour, the phone only fetches online data hourly
+// jitter keeps the request off the exact tick
+// while the timeline has enough slots left the face steps through it instead
+static void job_weather(void) {
+    weather_timeline_advance();
+    if (weather_timeline_left(time(NULL)) > WEATHER_TIMELINE_REFETCH) {
+        STATS_INC(weather_requests_skipped);
+        return;
     }
-    if((t->tm_min % 5 == 0) && (health_fetched == false)) {
-        request_health();
-        health_fetched = true;
+    if (bluetooth_enabled == true) {
+        request_weather();
     }
-    #endif
-    
-    if(t->tm_min == 59) {
-        weather_fetched = false;
-        health_fetched = false;
+}
+
+// vibrate at start of every hour
+static void job_hourvibe(void) {
+    if (settings.hourvibes == 1) {
+        vibes_long_pulse();
     }
-    
+}
 
-	
-	// vibrate at start of every hour
-	if(settings.hourvibes == 1) {
-		if((t->tm_min == 0) && (t->tm_sec == 1)) {
-            vibes_long_pulse();
-		}
-	}
+// sun times for the new day at midnight, from the position of the last weather
+static void job_suntimes(void) {
+    weatherdata previous = cachedWeather;
+    suntimes_update();
+    weather_show_changed(&previous);
 }
 
+static SchedulerJob s_weather_job = { .name = "weather", .callback = job_weather, .period = 60, .offset = 1, .jitter_ms = 5000 };
+static SchedulerJob s_hourvibe_job = { .name = "hourvibe", .callback = job_hourvibe, .period = 60, .offset = 0 };
+static SchedulerJob s_suntimes_job = { .name = "suntimes", .callback = job_suntimes, .period = 24 * 60, .offset = 0 };
+
+static void jobs_start(void) {
+    time_t now = time(NULL);
+    scheduler_init(localtime(&now));
+    scheduler_add(&s_weather_job);
+    scheduler_add(&s_hourvibe_job);
+    scheduler_add(&s_suntimes_job);
+}
+
+
+//======================================
+// DATE UPDATER
+//======================================
+// should do localization here later
+// the text only changes at midnight, the label redraws it from the buffer in between
+static void date_update(const struct tm *t) {
+  compositor_invalidate();
+  TELEMETRY_BEGIN(telemetry_start);
+  format_day(s_day_buffer, sizeof(s_day_buffer), t);
+  info_changed(INFO_DAY);
+  STATS_INC(layers_marked);
+  TELEMETRY_END(TELEMETRY_DATE, telemetry_start);
+}
+
+
 //======================================
 // TIME TICK HANDLER
 //======================================
+// a second hand frame puts back the dial under the old second hand and the hands over it
+// text and icons the old hand crossed are damaged, the dial goes back under their whole frame
+// and they are drawn again, so is anything else whose frame overlaps a damaged one
+// the bluetooth icon is drawn by the system in every frame, the hands never reach it
+// the center box is never crossed, the second hand stops at it, but the city overlaps it
+// a second hand drawn with GPath has no rows to restore, those frames are always full
+static bool compositor_frames_overlap(GRect a, GRect b) {
+    return (a.origin.x < b.origin.x + b.size.w) && (b.origin.x < a.origin.x + a.size.w) &&
+           (a.origin.y < b.origin.y + b.size.h) && (b.origin.y < a.origin.y + a.size.h);
+}
+
+static bool compositor_item_shown(uint8_t item) {
+    if (item < INFO_SLOTS) {
+        return (item != INFO_TEMPERATURE) && (INFO_SLOT_TABLE[item].text[0] != '\0');
+    }
+    return true;
+}
+
+static bool compositor_partial_possible(void) {
+    if (!s_second_rows_drawn) {
+        return false;
+    }
+    GRect bounds = layer_get_bounds(window_get_root_layer(window));
+    GRect box = center_box(bounds);
+    for (uint8_t item = 0; item < INFO_SLOTS; ++item) {
+        s_compositor_damage_frame[item] = INFO_SLOT_TABLE[item].frame;
+    }
+    s_compositor_damage_frame[COMPOSITOR_FORECASTICON] = layer_get_frame(s_forecasticon_layer);
+    s_compositor_damage_frame[COMPOSITOR_CENTER_BOX] = GRect(box.origin.x - 1, box.origin.y - 1, box.size.w + 2, box.size.h + 2); // wide outline
+
+    s_compositor_damage = 0;
+    for (uint8_t item = 0; item < COMPOSITOR_CENTER_BOX; ++item) {
+        if (compositor_item_shown(item) && hand_raster_rows_touch(&s_second_rows, s_compositor_damage_frame[item])) {
+            s_compositor_damage |= 1 << item;
+        }
+    }
+    for (bool grown = (s_compositor_damage != 0); grown;) {
+        grown = false;
+        for (uint8_t item = 0; item < COMPOSITOR_ITEMS; ++item) {
+            if ((s_compositor_damage & (1 << item)) || !compositor_item_shown(item)) {
+                continue;
+            }
+            for (uint8_t other = 0; other < COMPOSITOR_ITEMS; ++other) {
+                if ((s_compositor_damage & (1 << other)) &&
+                    compositor_frames_overlap(s_compositor_damage_frame[item], s_compositor_damage_frame[other])) {
+                    s_compositor_damage |= 1 << item;
+                    grown = true;
+                    break;
+                }
+            }
+        }
+    }
+    return true;
+}
+
 // ticks per second or minute, see init below, also allows changes through appsync
+// marks the layers whose content changed with this tick, but the system draws every
+// layer of the window when any one is dirty, so the marking itself saves no drawing
+// the savings come from procs skipping work, see s_compositor_partial
 static void handle_time_tick(struct tm *tick_time, TimeUnits units_changed) {
-  layer_mark_dirty(window_get_root_layer(window));
+    s_frame_time = *tick_time;
+    s_compositor_partial = (units_changed == SECOND_UNIT) && seconds_visible() && compositor_partial_possible();
+
+    #if DEBUG_PROFILE
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "previous tick: %d layers marked, %d layers drawn, %d pixels written",
+            s_stats.layers_marked, s_stats.layers_drawn, (int)s_stats.pixels_written);
+    s_stats.layers_marked = 0;
+    s_stats.layers_drawn = 0;
+    s_stats.pixels_written = 0;
+
+    // average dial cost per frame, drawn vs. blitted from the cache
+    if (units_changed & MINUTE_UNIT) {
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "dial: %d renders avg %d us, %d blits avg %d us",
+                s_stats.dial_renders, s_stats.dial_renders ? (int)(s_stats.dial_render_ms * 1000 / s_stats.dial_renders) : 0,
+                s_stats.dial_blits, s_stats.dial_blits ? (int)(s_stats.dial_blit_ms * 1000 / s_stats.dial_blits) : 0);
+    }
+    if (units_changed & HOUR_UNIT) {
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "resource loads last hour: %d, health queries: %d", s_stats.resource_loads, s_stats.health_queries);
+        s_stats.resource_loads = 0;
+        s_stats.health_queries = 0;
+        scheduler_log();
+    }
+    if (units_changed & DAY_UNIT) {
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "yesterday: %d messages and %d redraws suppressed, %d flash writes, %d suppressed",
+                s_stats.messages_suppressed, s_stats.redraws_suppressed, s_stats.flash_writes, s_stats.flash_writes_suppressed);
+        s_stats.messages_suppressed = 0;
+        s_stats.redraws_suppressed = 0;
+        s_stats.flash_writes = 0;
+        s_stats.flash_writes_suppressed = 0;
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "yesterday: %d second ticks avoided, %d weather requests skipped",
+                (int)s_stats.second_ticks_avoided, s_stats.weather_requests_skipped);
+        s_stats.second_ticks_avoided = 0;
+        s_stats.weather_requests_skipped = 0;
+    }
+
+    // second ticks the window saved this minute, full minutes while it is closed
+    s_stats.second_ticks++;
+    if (units_changed & MINUTE_UNIT) {
+        if ((settings.seconds == 1) && (settings.secondswindow > 0) && (s_power_stage < POWER_SAVE)) {
+            s_stats.second_ticks_avoided += (s_stats.second_ticks < 60) ? 60 - s_stats.second_ticks : 0;
+        }
+        s_stats.second_ticks = 0;
+    }
+    #endif
+
+    if ((units_changed & SECOND_UNIT) && seconds_visible()) {
+        layer_mark_dirty(s_seconds_layer);
+        STATS_INC(layers_marked);
+    }
+    if (units_changed & MINUTE_UNIT) { // hour hand moves with the minutes too
+        layer_mark_dirty(s_hands_layer);
+        STATS_INC(layers_marked);
+    }
+    if (units_changed & DAY_UNIT) {
+        date_update(tick_time);
+    }
+
+    // periodic jobs, health totals and coalesced settings and weather cache writes
+    if (units_changed & MINUTE_UNIT) {
+        scheduler_tick(tick_time);
+        #if defined(PBL_HEALTH)
+        health_tick();
+        #endif
+        storage_flush_all(false);
+    }
 }
 
 
 //======================================
-// DATE UPDATER
+// SECONDS WINDOW
 //======================================
-// should do localization here later
-static void date_update_proc(Layer *layer, GContext *ctx) {
-  time_t now = time(NULL);
-  struct tm *t = localtime(&now);
-  strftime(s_day_buffer, sizeof(s_day_buffer), "%a %d", t);
-  text_layer_set_text(s_day_label, s_day_buffer);
+// the face ticks per minute and a tap or wrist flick runs the second hand for a while
+static AppTimer *s_seconds_timer = NULL;
+
+static void seconds_tick_subscribe(void) {
+    tick_timer_service_subscribe(seconds_visible() ? SECOND_UNIT : MINUTE_UNIT, handle_time_tick);
+}
+
+static void seconds_window_close(void *data) {
+    s_seconds_timer = NULL;
+    s_seconds_window_open = false;
+    seconds_tick_subscribe();
+    layer_mark_dirty(s_seconds_layer); // clear second hand
+}
+
+// another tap while open just keeps it open longer
+static void handle_tap(AccelAxisType axis, int32_t direction) {
+    uint32_t timeout_ms = settings.secondswindow * 1000;
+    if (s_seconds_timer) {
+        app_timer_reschedule(s_seconds_timer, timeout_ms);
+        return;
+    }
+    s_seconds_window_open = true;
+    s_seconds_timer = app_timer_register(timeout_ms, seconds_window_close, NULL);
+    seconds_tick_subscribe();
+    layer_mark_dirty(s_seconds_layer);
+}
+
+// pick the tick rate and tap subscription for the current seconds settings
+static void seconds_mode_update(void) {
+    if (s_seconds_timer) {
+        app_timer_cancel(s_seconds_timer);
+        s_seconds_timer = NULL;
+    }
+    s_seconds_window_open = false;
+
+    if ((settings.seconds == 1) && (settings.secondswindow > 0) && (s_power_stage < POWER_SAVE)) {
+        accel_tap_service_subscribe(handle_tap);
+    }
+    else {
+        accel_tap_service_unsubscribe();
+    }
+    seconds_tick_subscribe();
 }
 
 
@@ -395,174 +1466,168 @@ static void sync_error_callback(DictionaryResult dict_error, AppMessageResult ap
 // Called every time watch or phone sends appsync dictionary
 // Save settings to watch storage
 static void sync_tuple_changed_callback(const uint32_t key, const Tuple* t, const Tuple* old_tuple, void* context) {
+  TELEMETRY_BEGIN(telemetry_start);
+  TELEMETRY_COUNT(TELEMETRY_MESSAGES_IN);
   switch (key) {
-    case WEATHER_ICON:
-        cachedWeather.icon_current = t->value->uint8;
-        if (s_icon_bitmap) {
-            gbitmap_destroy(s_icon_bitmap);
-        }
-          if (settings.reverse == 1) {
-              s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_REVERSE[cachedWeather.icon_current]);
-          }
-          else {
-              s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS[cachedWeather.icon_current]);
-          }
-        bitmap_layer_set_bitmap(s_icon_layer, s_icon_bitmap);
+    case WEATHER_PACKED:
+        weather_record_apply(t->value->data, t->length);
     break;
 
-    case WEATHER_TEMPERATURE:
-        snprintf(cachedWeather.temperature, sizeof(cachedWeather.temperature), "%s",  t->value->cstring);
-      	text_layer_set_text(s_temperature_label, cachedWeather.temperature);
+    case WEATHER_TIMELINE:
+        weather_timeline_apply(t->value->data, t->length);
     break;
 
-    case WEATHER_CITY:
-        snprintf(cachedWeather.city, sizeof(cachedWeather.city), "%s",  t->value->cstring);
-      	text_layer_set_text(s_city_label, cachedWeather.city);
-    break;
-	  
-	case WEATHER_SUNTIMES:
-        snprintf(cachedWeather.suntimes, sizeof(cachedWeather.suntimes), "%s",  t->value->cstring);
-      	text_layer_set_text(s_suntimes_label, cachedWeather.suntimes);
+    #if TELEMETRY
+    case TELEMETRY_REQUEST:
+        if (t->value->uint8 != 0) { // 0 is the initial value
+            telemetry_export();
+        }
     break;
-	  
- 	case WEATHER_FORECASTICON:
-        cachedWeather.forecasticon = t->value->uint8;
-		if (s_forecasticon_bitmap) {
-        	gbitmap_destroy(s_forecasticon_bitmap);
-      	}
-          if (settings.reverse == 1) {
-              s_forecasticon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_SMALL_REVERSE[cachedWeather.forecasticon]);
-          }
-          else {
-              s_forecasticon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_SMALL[cachedWeather.forecasticon]);
-          }
-      	bitmap_layer_set_bitmap(s_forecasticon_layer, s_forecasticon_bitmap);
-	break;
-
-  	case WEATHER_MINMAXTEMP:
-		snprintf(cachedWeather.minmaxtemp, sizeof(cachedWeather.minmaxtemp), "%s",  t->value->cstring);
-      	text_layer_set_text(s_minmaxtemp_label, cachedWeather.minmaxtemp);
-	break;
-
-  	case WEATHER_MISC:
-		snprintf(cachedWeather.misc, sizeof(cachedWeather.misc), "%s",  t->value->cstring);
-      	text_layer_set_text(s_misc_label, cachedWeather.misc);
-        // write data to weather cache on watch
-        persist_write_data(PERSIST_WEATHERDATA, &cachedWeather, sizeof(cachedWeather));
-	break;
+    #endif
 					
+	// config values that didn't change need no resubscribe, restyle or health query
 	case CONFIG_SECONDS:
-        settings.seconds = t->value->uint8;
-        if (t->value->uint8 == 1) {
-          tick_timer_service_subscribe(SECOND_UNIT, handle_time_tick);
-        }
-        else {
-          tick_timer_service_subscribe(MINUTE_UNIT, handle_time_tick);
+        if (settings.seconds == t->value->uint8) {
+            STATS_INC(messages_suppressed);
+            break;
         }
+        settings.seconds = t->value->uint8;
+        storage_mark_dirty(&s_settings_store);
+        seconds_mode_update();
+        layer_mark_dirty(s_seconds_layer); // show or clear second hand
 	break;
 
+    case CONFIG_SECONDSWINDOW:
+        if (settings.secondswindow == t->value->uint8) {
+            STATS_INC(messages_suppressed);
+            break;
+        }
+        settings.secondswindow = t->value->uint8;
+        storage_mark_dirty(&s_settings_store);
+        seconds_mode_update();
+        layer_mark_dirty(s_seconds_layer);
+    break;
+
 	case CONFIG_HOURVIBES:
+        if (settings.hourvibes == t->value->uint8) {
+            STATS_INC(messages_suppressed);
+            break;
+        }
         settings.hourvibes = t->value->uint8;
+        storage_mark_dirty(&s_settings_store);
 	break;
           
     case CONFIG_DISTANCE:
+        if (settings.distance == t->value->uint8) {
+            STATS_INC(messages_suppressed);
+            break;
+        }
         settings.distance = t->value->uint8;
+        storage_mark_dirty(&s_settings_store);
     #if defined(PBL_HEALTH)
-        request_health();
+        health_show(); // both totals are already known
     #endif
     break;
           
     case CONFIG_BLUETHEME:
+        if (settings.bluetheme == t->value->uint8) {
+            STATS_INC(messages_suppressed);
+            break;
+        }
         settings.bluetheme = t->value->uint8;
-//        color_handler();
-//          APP_LOG(APP_LOG_LEVEL_DEBUG, "bluetheme: %d", settings.bluetheme);
+        storage_mark_dirty(&s_settings_store);
+        theme_switch();
     break;
 
     case CONFIG_REVERSE:
+          if (settings.reverse == t->value->uint8) {
+              STATS_INC(messages_suppressed);
+              break;
+          }
           settings.reverse = t->value->uint8;
-          color_handler();
-          
-          // numerals for 12, 4, 8 o'clock
-          text_layer_set_text_color(s_label_12, color_maintext);
-          text_layer_set_background_color(s_label_12, color_maintextbackground);
-          text_layer_set_text_color(s_label_4, color_maintext);
-          text_layer_set_background_color(s_label_4, color_maintextbackground);
-          text_layer_set_text_color(s_label_8, color_maintext);
-          text_layer_set_background_color(s_label_8, color_maintextbackground);
-          
-          // date label
-          text_layer_set_text_color(s_day_label, color_maintext);
-          text_layer_set_background_color(s_day_label, color_maintextbackground);
-          
-          // battery label
-          text_layer_set_text_color(s_battery_label, color_cornertext);
-          text_layer_set_background_color(s_battery_label, color_cornertextbackground);
-          
-          // main temperature label
-          text_layer_set_text_color(s_temperature_label, color_maintext);
-          text_layer_set_background_color(s_temperature_label, color_maintextbackground);
-          
-          // city label
-          text_layer_set_text_color(s_city_label, color_cornertext);
-          text_layer_set_background_color(s_city_label, color_cornertextbackground);
-          
-          // sunrise sunset label
-          text_layer_set_text_color(s_suntimes_label, color_cornertext);
-          text_layer_set_background_color(s_suntimes_label, color_cornertextbackground);
+          storage_mark_dirty(&s_settings_store);
+          theme_switch();
+          break;
 
-          // minmax temperature label
-          text_layer_set_text_color(s_minmaxtemp_label, color_cornertext);
-          text_layer_set_background_color(s_minmaxtemp_label, color_cornertextbackground);
 
-          // misc label
-          text_layer_set_text_color(s_misc_label, color_cornertext);
-          text_layer_set_background_color(s_misc_label, color_cornertextbackground);
-          
-          // fitness label
-          text_layer_set_text_color(s_fitness_label, color_cornertext);
-          text_layer_set_background_color(s_fitness_label, color_cornertextbackground);
-          
-          // set main weather icon
-          if (s_icon_bitmap) {
-              gbitmap_destroy(s_icon_bitmap);
-          }
-          if (settings.reverse == 1) {
-              s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_REVERSE[cachedWeather.icon_current]);
-          }
-          else {
-              s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS[cachedWeather.icon_current]);
-          }
-          bitmap_layer_set_bitmap(s_icon_layer, s_icon_bitmap);
+  }
+  TELEMETRY_END(TELEMETRY_SYNC, telemetry_start);
+}
 
-          // set forecast icon
-          if (s_forecasticon_bitmap) {
-              gbitmap_destroy(s_forecasticon_bitmap);
-          }
-          if (settings.reverse == 1) {
-              s_forecasticon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_SMALL_REVERSE[cachedWeather.forecasticon]);
-          }
-          else {
-              s_forecasticon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_SMALL[cachedWeather.forecasticon]);
-          }
-          bitmap_layer_set_bitmap(s_forecasticon_layer, s_forecasticon_bitmap);
-          
-          break;
 
+//======================================
+// POWER GOVERNOR
+//======================================
+// degrade in stages as the battery drains, everything comes back once charging starts
+// stage changes are logged with the time spent in the old stage to see what each one buys
+static time_t s_power_stage_since = 0;
+static uint8_t s_power_stage_percent = 100;
+
+static uint8_t power_stage_for(BatteryChargeState charge_state) {
+    if (charge_state.is_charging || charge_state.is_plugged) {
+        return POWER_NORMAL;
+    }
+    if (charge_state.charge_percent < 10) {
+        return POWER_CRITICAL;
+    }
+    if (charge_state.charge_percent < 20) {
+        return POWER_LOW;
+    }
+    if (charge_state.charge_percent < 30) {
+        return POWER_SAVE;
+    }
+    return POWER_NORMAL;
+}
 
-  }
+static void power_stage_set(uint8_t stage, uint8_t percent) {
+    if (stage == s_power_stage) {
+        return;
+    }
+    time_t now = time(NULL);
+    if (s_power_stage_since) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "power stage %d -> %d at %d%%, %d min and %d%% in stage %d",
+                s_power_stage, stage, percent, (int)((now - s_power_stage_since) / 60),
+                s_power_stage_percent - percent, s_power_stage);
+    }
+    else {
+        APP_LOG(APP_LOG_LEVEL_INFO, "power stage %d at %d%%", stage, percent);
+    }
+    uint8_t previous = s_power_stage;
+    s_power_stage = stage;
+    s_power_stage_since = now;
+    s_power_stage_percent = percent;
+
+    // second hand and tap service
+    if ((previous < POWER_SAVE) != (stage < POWER_SAVE)) {
+        seconds_mode_update();
+        layer_mark_dirty(s_seconds_layer);
+    }
+
+    // weather polling
+    scheduler_set_period(&s_weather_job, (stage >= POWER_LOW) ? 180 : 60);
+
+    // health events, subscribing again brings the totals up to date
+    #if defined(PBL_HEALTH)
+    if ((previous < POWER_CRITICAL) && (stage >= POWER_CRITICAL)) {
+        health_service_events_unsubscribe();
+    }
+    else if ((previous >= POWER_CRITICAL) && (stage < POWER_CRITICAL)) {
+        health_service_events_subscribe(handle_health, NULL);
+    }
+    #endif
 }
 
 
 //======================================
 // BATTERY LEVEL HANDLER
 //======================================
+// one ! per power stage after the charge level
 static void handle_battery(BatteryChargeState charge_state) {
-  if (charge_state.is_charging) {
-    snprintf(s_battery_buffer, sizeof(s_battery_buffer), "+%d",  charge_state.charge_percent);
-  } else {
-    snprintf(s_battery_buffer, sizeof(s_battery_buffer), "%d", charge_state.charge_percent);
-  }
-  text_layer_set_text(s_battery_label, s_battery_buffer);
+  compositor_invalidate();
+  power_stage_set(power_stage_for(charge_state), charge_state.charge_percent);
+
+  format_battery(s_battery_buffer, sizeof(s_battery_buffer), charge_state.charge_percent, charge_state.is_charging, s_power_stage);
+  info_changed(INFO_BATTERY);
 }
 
 
@@ -570,6 +1635,7 @@ static void handle_battery(BatteryChargeState charge_state) {
 // BLUETOOTH CONNECTION HANDLER
 //======================================
 static void handle_bluetooth(bool connected_state) {
+    compositor_invalidate();
     if (connected_state == true) {
         bluetooth_enabled = true;
         if (s_bluetooth_bitmap) {
@@ -583,175 +1649,381 @@ static void handle_bluetooth(bool connected_state) {
             gbitmap_destroy(s_bluetooth_bitmap);
         }
         s_bluetooth_bitmap = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BLUETOOTH);
+        STATS_INC(resource_loads);
         bitmap_layer_set_bitmap(s_bluetooth_layer, s_bluetooth_bitmap);
     }
 }
 
 
+//======================================
+// RENDER BENCHMARK
+//======================================
+// only built with DEBUG_BENCHMARK, drives the draw procs for every minute
+// of a day in every theme and logs time, pixels written and heap growth
+// per frame. Runs an hour of fake time per frame to keep the watchdog happy.
+// The label formatters are checked and timed once before the first frame.
+#if DEBUG_BENCHMARK
+#define BENCH_THEMES 4 // reverse x bluetheme
+#define BENCH_MINUTES (24 * 60)
+#define BENCH_MINUTES_PER_FRAME 60
+
+typedef struct {
+    const char *name;
+    LayerUpdateProc proc;
+    Layer **layer;
+    uint32_t ms;         // time spent inside the proc
+    uint32_t pixels;     // pixels written by the proc
+    uint32_t heap_bytes; // heap growth across calls
+} BenchTarget;
+
+// the GPath hands the rasterizer replaced, for comparison
+static void bench_hands_gpath_proc(Layer *layer, GContext *ctx) {
+    hands_draw_gpath(ctx, &s_frame_time);
+}
+
+static BenchTarget s_bench_targets[] = {
+    { "bg", bg_update_proc, &s_simple_bg_layer, 0, 0, 0 },
+    { "info", info_update_proc, &s_info_layer, 0, 0, 0 },
+    { "icon", icon_update_proc, &s_icon_layer, 0, 0, 0 },
+    { "forecast icon", forecasticon_update_proc, &s_forecasticon_layer, 0, 0, 0 },
+    { "hands", hands_update_proc, &s_hands_layer, 0, 0, 0 },
+    { "hands gpath", bench_hands_gpath_proc, &s_hands_layer, 0, 0, 0 },
+    { "seconds", seconds_update_proc, &s_seconds_layer, 0, 0, 0 }
+};
+
+static Layer *s_bench_layer;
+static int s_bench_theme = 0, s_bench_minute = 0;
+static persist s_bench_saved_settings;
+
+// fill the frame buffer with a marker byte, or count the pixels that differ from it
+static uint32_t bench_frame_buffer(GContext *ctx, uint8_t marker, bool count) {
+    GBitmap *fb = graphics_capture_frame_buffer(ctx);
+    uint32_t pixels = 0;
+    if (!fb) {
+        return 0;
+    }
+
+    uint8_t *data = gbitmap_get_data(fb);
+    uint16_t stride = gbitmap_get_bytes_per_row(fb);
+    GSize size = gbitmap_get_bounds(fb).size;
+    for (int16_t y = 0; y < size.h; ++y) {
+        uint8_t *row = data + y * stride;
+        if (!count) {
+            memset(row, marker, stride);
+            continue;
+        }
+        #ifdef PBL_COLOR
+        for (int16_t x = 0; x < size.w; ++x) {
+            pixels += (row[x] != marker);
+        }
+        #else
+        for (int16_t x = 0; x < size.w; ++x) {
+            pixels += ((row[x / 8] ^ marker) >> (x % 8)) & 1;
+        }
+        #endif
+    }
+
+    graphics_release_frame_buffer(ctx, fb);
+    return pixels;
+}
+
+static void bench_target_frame(BenchTarget *target, GContext *ctx) {
+    // drawn pixels always have alpha set, so a colour frame buffer never holds 0x00 after drawing.
+    // a 1 bit frame buffer needs a black and a white pass to see every written pixel
+    bench_frame_buffer(ctx, 0x00, false);
+    size_t heap_before = heap_bytes_used();
+    uint32_t start = profile_time_ms();
+    target->proc(*target->layer, ctx);
+    target->ms += profile_time_ms() - start;
+    if (heap_bytes_used() > heap_before) {
+        target->heap_bytes += heap_bytes_used() - heap_before;
+    }
+    target->pixels += bench_frame_buffer(ctx, 0x00, true);
+
+    #ifndef PBL_COLOR
+    bench_frame_buffer(ctx, 0xFF, false);
+    target->proc(*target->layer, ctx);
+    target->pixels += bench_frame_buffer(ctx, 0xFF, true);
+    #endif
+}
+
+static void bench_next_frame(void *data) {
+    if (s_bench_theme < BENCH_THEMES) {
+        layer_mark_dirty(s_bench_layer);
+    }
+    else {
+        layer_set_hidden(s_bench_layer, true);
+        layer_mark_dirty(window_get_root_layer(window));
+    }
+}
+
+// time per call in picoseconds of something that takes well under a millisecond,
+// the clock only has milliseconds, so call runs in batches until BENCH_MIN_MS have passed
+// logged as ns with BENCH_PS_FORMAT, a theme switch takes less than one on a desktop
+#define BENCH_MIN_MS 200
+#define BENCH_BATCH 1000
+#define BENCH_PS_FORMAT "%d.%03d ns"
+#define BENCH_PS_ARGS(ps) (int)((ps) / 1000), (int)((ps) % 1000)
+static uint32_t bench_ps_per_call(void (*call)(int i)) {
+    void (*volatile opaque)(int i) = call; // not inlined, so a loop of them can't be folded into one
+    uint32_t calls = 0, ms;
+    uint32_t start = profile_time_ms();
+    do {
+        for (int i = 0; i < BENCH_BATCH; ++i) {
+            opaque(calls + i);
+        }
+        calls += BENCH_BATCH;
+        ms = profile_time_ms() - start;
+    } while (ms < BENCH_MIN_MS);
+    return (uint64_t)ms * 1000000000 / calls;
+}
+
+// cost of one theme switch, the redraw that follows is in the per theme frame numbers
+static void bench_theme_call(int i) {
+    settings.reverse = (i >> 1) & 1;
+    settings.bluetheme = i & 1;
+    color_handler();
+}
+
+static void bench_theme_switch(void) {
+    persist saved = settings;
+    uint32_t ps = bench_ps_per_call(bench_theme_call);
+    settings = saved;
+    color_handler();
+    APP_LOG(APP_LOG_LEVEL_INFO, "bench theme switch: " BENCH_PS_FORMAT, BENCH_PS_ARGS(ps));
+}
+
+// label formatters against the snprintf and strftime calls they replaced,
+// logs mismatching outputs and the time per call of both
+static const char *const s_bench_stage_marks[] = { "", "!", "!!", "!!!" };
+static char s_bench_text[18];
+
+static void bench_format_ours_call(int i) {
+    struct tm day = { .tm_wday = i % 7, .tm_mday = 1 + i % 31 };
+    format_battery(s_bench_text, sizeof(s_bench_text), i % 101, false, i % 4);
+    format_fitness(s_bench_text, sizeof(s_bench_text), i * 7, i & 1);
+    format_day(s_bench_text, sizeof(s_bench_text), &day);
+}
+
+static void bench_format_libc_call(int i) {
+    struct tm day = { .tm_wday = i % 7, .tm_mday = 1 + i % 31 };
+    snprintf(s_bench_text, sizeof(s_bench_text), "%d%s", i % 101, s_bench_stage_marks[i % 4]);
+    snprintf(s_bench_text, sizeof(s_bench_text), (i & 1) ? "%d m" : "%dx", i * 7);
+    strftime(s_bench_text, sizeof(s_bench_text), "%a %d", &day);
+}
+
+static void bench_formatters(void) {
+    char ours[18], libc[18];
+    int mismatches = 0;
+    struct tm day = { .tm_mday = 1 };
+
+    // same output for every value the labels show
+    for (int percent = 0; percent <= 100; ++percent) {
+        for (int marks = 0; marks < 4; ++marks) {
+            format_battery(ours, sizeof(ours), percent, false, marks);
+            snprintf(libc, sizeof(libc), "%d%s", percent, s_bench_stage_marks[marks]);
+            mismatches += (strcmp(ours, libc) != 0);
+        }
+        format_battery(ours, sizeof(ours), percent, true, 0);
+        snprintf(libc, sizeof(libc), "+%d", percent);
+        mismatches += (strcmp(ours, libc) != 0);
+    }
+    for (int32_t value = 0; value < 100000; value += 37) {
+        format_fitness(ours, sizeof(ours), value, true);
+        snprintf(libc, sizeof(libc), "%d m", (int)value);
+        mismatches += (strcmp(ours, libc) != 0);
+        format_fitness(ours, sizeof(ours), value, false);
+        snprintf(libc, sizeof(libc), "%dx", (int)value);
+        mismatches += (strcmp(ours, libc) != 0);
+    }
+    for (int i = 0; i < 7 * 31; ++i) {
+        day.tm_wday = i % 7;
+        day.tm_mday = 1 + i % 31;
+        format_day(ours, sizeof(ours), &day);
+        strftime(libc, sizeof(libc), "%a %d", &day);
+        mismatches += (strcmp(ours, libc) != 0);
+    }
+    APP_LOG(APP_LOG_LEVEL_INFO, "bench format: %d mismatches", mismatches);
+
+    // time per call
+    uint32_t ours_ps = bench_ps_per_call(bench_format_ours_call);
+    uint32_t libc_ps = bench_ps_per_call(bench_format_libc_call);
+    APP_LOG(APP_LOG_LEVEL_INFO, "bench format: battery+fitness+day " BENCH_PS_FORMAT ", snprintf/strftime " BENCH_PS_FORMAT,
+            BENCH_PS_ARGS(ours_ps), BENCH_PS_ARGS(libc_ps));
+}
+
+static void bench_update_proc(Layer *layer, GContext *ctx) {
+    if (s_bench_theme >= BENCH_THEMES) {
+        return;
+    }
+
+    // new theme
+    if (s_bench_minute == 0) {
+        if (s_bench_theme == 0) {
+            s_bench_saved_settings = settings;
+            bench_formatters();
+            bench_theme_switch();
+        }
+        settings.reverse = s_bench_theme >> 1;
+        settings.bluetheme = s_bench_theme & 1;
+        settings.seconds = 1;
+        settings.secondswindow = 0;
+        color_handler();
+        for (uint32_t i = 0; i < ARRAY_LENGTH(s_bench_targets); ++i) {
+            s_bench_targets[i].ms = 0;
+            s_bench_targets[i].pixels = 0;
+            s_bench_targets[i].heap_bytes = 0;
+        }
+    }
+
+    // the procs skip most of their work in second hand frames, time the full draw
+    compositor_invalidate();
+    time_t today = time_start_of_today();
+    for (int m = s_bench_minute; m < s_bench_minute + BENCH_MINUTES_PER_FRAME; ++m) {
+        frame_time_set(today + m * 60 + m % 60);
+        for (uint32_t i = 0; i < ARRAY_LENGTH(s_bench_targets); ++i) {
+            bench_target_frame(&s_bench_targets[i], ctx);
+        }
+    }
+    frame_time_set(time(NULL));
+    s_bench_minute += BENCH_MINUTES_PER_FRAME;
+
+    // theme done, report per frame averages
+    if (s_bench_minute >= BENCH_MINUTES) {
+        for (uint32_t i = 0; i < ARRAY_LENGTH(s_bench_targets); ++i) {
+            BenchTarget *target = &s_bench_targets[i];
+            APP_LOG(APP_LOG_LEVEL_INFO, "bench theme %d %s: %d ns/frame, %d px/frame, %d heap bytes/frame",
+                    s_bench_theme, target->name,
+                    (int)((uint64_t)target->ms * 1000000 / BENCH_MINUTES),
+                    (int)(target->pixels / BENCH_MINUTES),
+                    (int)(target->heap_bytes / BENCH_MINUTES));
+        }
+        s_bench_minute = 0;
+        s_bench_theme++;
+    }
+
+    // all themes done, back to normal
+    if (s_bench_theme >= BENCH_THEMES) {
+        settings = s_bench_saved_settings;
+        color_handler();
+    }
+    app_timer_register(10, bench_next_frame, NULL);
+}
+#endif
+
+
+//======================================
+// FOCUS
+//======================================
+// notifications and system windows draw over the frame buffer, and with a clear
+// window background nothing wipes them, the first frame after one is drawn in full
+static void redraw_all(void) {
+    compositor_invalidate();
+    layer_mark_dirty(window_get_root_layer(window));
+}
+
+static void handle_focus(bool in_focus) {
+    if (in_focus) {
+        redraw_all();
+    }
+}
+
+static void window_appear(Window *window) {
+    redraw_all();
+}
+
+
 //======================================
 // MAIN WINDOW LOADER
 //======================================
 static void window_load(Window *window) {
 	Layer *window_layer = window_get_root_layer(window);
 	GRect bounds = layer_get_bounds(window_layer);
+    #if DEBUG_PROFILE
+    size_t heap_before = heap_bytes_used();
+    #endif
 
     // create custom GFont
     custom_font_numerals = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_ROUNDY_34_BOLD));
-    
-	// black background
+
+
+	// black background with hour ticks and numerals for 12, 4, 8 o'clock
 	s_simple_bg_layer = layer_create(bounds);
 	layer_set_update_proc(s_simple_bg_layer, bg_update_proc);
 	layer_add_child(window_layer, s_simple_bg_layer);
 
-	// add numerals for 12, 4, 8 o'clock
-	s_label_12 = text_layer_create(GRect(bounds.size.w / 2 - 25, -9, 50, 45));
-	text_layer_set_text(s_label_12, "12");
-	text_layer_set_text_color(s_label_12, color_maintext);
-    text_layer_set_background_color(s_label_12, color_maintextbackground);
-//    text_layer_set_font(s_label_12, fonts_get_system_font(FONT_KEY_BITHAM_34_MEDIUM_NUMBERS));
-    text_layer_set_font(s_label_12, custom_font_numerals);
-	text_layer_set_text_alignment(s_label_12, GTextAlignmentCenter);
-	layer_add_child(window_layer, text_layer_get_layer(s_label_12));
-
-	s_label_4 = text_layer_create(GRect(112, 100, 30, 40));
-	text_layer_set_text(s_label_4, "4");
-	text_layer_set_text_color(s_label_4, color_maintext);
-    text_layer_set_background_color(s_label_4, color_maintextbackground);
-//    text_layer_set_font(s_label_4, fonts_get_system_font(FONT_KEY_BITHAM_34_MEDIUM_NUMBERS));
-    text_layer_set_font(s_label_4, custom_font_numerals);
-	text_layer_set_text_alignment(s_label_4, GTextAlignmentRight);
-	layer_add_child(window_layer, text_layer_get_layer(s_label_4));
-
-	s_label_8 = text_layer_create(GRect(2, 100, 30, 40));
-	text_layer_set_text(s_label_8, "8");
-	text_layer_set_text_color(s_label_8, color_maintext);
-    text_layer_set_background_color(s_label_8, color_maintextbackground);
-//    text_layer_set_font(s_label_8, fonts_get_system_font(FONT_KEY_BITHAM_34_MEDIUM_NUMBERS));
-    text_layer_set_font(s_label_8, custom_font_numerals);
-	text_layer_set_text_alignment(s_label_8, GTextAlignmentLeft);
-	layer_add_child(window_layer, text_layer_get_layer(s_label_8));
-
-	// add battery label
-	s_battery_label = text_layer_create(GRect(3, 0, 30, 20));
-	text_layer_set_text_color(s_battery_label, color_cornertext);
-    text_layer_set_background_color(s_battery_label, color_cornertextbackground);
-	text_layer_set_font(s_battery_label, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-	text_layer_set_text_alignment(s_battery_label, GTextAlignmentLeft);
-	layer_add_child(window_layer, text_layer_get_layer(s_battery_label));
-
-    // fitness label
-    s_fitness_label = text_layer_create(GRect(bounds.size.w / 2 - 20, 150, 40, 20));
-    text_layer_set_font(s_fitness_label, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-    text_layer_set_text_alignment(s_fitness_label, GTextAlignmentCenter);
-    text_layer_set_text_color(s_fitness_label, color_cornertext);
-    text_layer_set_background_color(s_fitness_label, color_cornertextbackground);
-    layer_add_child(window_layer, text_layer_get_layer(s_fitness_label));
-    
-    // add date label
-    s_date_layer = layer_create(bounds);
-    layer_set_update_proc(s_date_layer, date_update_proc);
-    layer_add_child(window_layer, s_date_layer);
-    s_day_label = text_layer_create(GRect(bounds.size.w / 2 - 30, 133, 60, 25));
-    text_layer_set_text(s_day_label, s_day_buffer);
-    text_layer_set_text_color(s_day_label, color_maintext);
-    text_layer_set_background_color(s_day_label, color_maintextbackground);
-    text_layer_set_font(s_day_label, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_text_alignment(s_day_label, GTextAlignmentCenter);
-    layer_add_child(s_date_layer, text_layer_get_layer(s_day_label));
+    // off-screen copy of the dial, the size and format the frame buffer should have
+    // the first store replaces it if the frame buffer turns out different, see dial_cache_fits
+    // if this fails the dial just gets drawn every frame
+    #ifdef PBL_COLOR
+        s_dial_cache = gbitmap_create_blank(bounds.size, GBitmapFormat8Bit);
+    #else
+        s_dial_cache = gbitmap_create_blank(bounds.size, GBitmapFormat1Bit);
+    #endif
+    s_dial_cache_valid = false;
+
+	// battery, fitness, date, sun times, min-max, misc and city text, one layer draws them all
+	info_fonts_load();
+	s_info_layer = layer_create(bounds);
+	layer_set_update_proc(s_info_layer, info_update_proc);
+	layer_add_child(window_layer, s_info_layer);
+    date_update(&s_frame_time);
     
     // bluetooth icon
     s_bluetooth_layer = bitmap_layer_create(GRect(128, 0, 10, 15));
     bitmap_layer_set_compositing_mode(s_bluetooth_layer, GCompOpSet);
     layer_add_child(window_layer, bitmap_layer_get_layer(s_bluetooth_layer));
 
-	// add sunrise sunset labels
-	s_suntimes_label = text_layer_create(GRect(0, 30, 40, 30));
-	text_layer_set_text_color(s_suntimes_label, color_cornertext);
-    text_layer_set_background_color(s_suntimes_label, color_cornertextbackground);
-    text_layer_set_font(s_suntimes_label, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-	text_layer_set_text_alignment(s_suntimes_label, GTextAlignmentLeft);
-	layer_add_child(window_layer, text_layer_get_layer(s_suntimes_label));
-
     // add forecast icon
-    s_forecasticon_layer = bitmap_layer_create(GRect(bounds.size.w / 2 - 7, bounds.size.h / 2 - 45, 15, 15));
-    layer_add_child(window_layer, bitmap_layer_get_layer(s_forecasticon_layer));
-    if (s_forecasticon_bitmap) {
-        gbitmap_destroy(s_forecasticon_bitmap);
-    }
-    if (settings.reverse == 1) {
-        s_forecasticon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_SMALL_REVERSE[cachedWeather.forecasticon]);
-    }
-    else {
-        s_forecasticon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_SMALL[cachedWeather.forecasticon]);
-    }
-    bitmap_layer_set_bitmap(s_forecasticon_layer, s_forecasticon_bitmap);
-
-    // add minmax temp label
-	s_minmaxtemp_label = text_layer_create(GRect(102, 30, 40, 15));
-	text_layer_set_text_color(s_minmaxtemp_label, color_cornertext);
-	text_layer_set_background_color(s_minmaxtemp_label, color_cornertextbackground);
-	text_layer_set_font(s_minmaxtemp_label, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-	text_layer_set_text_alignment(s_minmaxtemp_label, GTextAlignmentRight);
-	layer_add_child(window_layer, text_layer_get_layer(s_minmaxtemp_label));
-
-    // add misc label for windspeed or humidity
-	s_misc_label = text_layer_create(GRect(82, 45, 60, 15));
-	text_layer_set_text_color(s_misc_label, color_cornertext);
-	text_layer_set_background_color(s_misc_label, color_cornertextbackground);
-	text_layer_set_font(s_misc_label, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-	text_layer_set_text_alignment(s_misc_label, GTextAlignmentRight);
-	layer_add_child(window_layer, text_layer_get_layer(s_misc_label));
-
-	// add city label
-	s_city_label = text_layer_create(GRect(bounds.size.w / 2 - 40, 107, 80, 30));
-	text_layer_set_text_color(s_city_label, color_cornertext);
-	text_layer_set_background_color(s_city_label, color_cornertextbackground);
-	text_layer_set_font(s_city_label, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-	text_layer_set_text_alignment(s_city_label, GTextAlignmentCenter);
-	layer_add_child(window_layer, text_layer_get_layer(s_city_label));
+    s_forecasticon_layer = layer_create(GRect(bounds.size.w / 2 - 7, bounds.size.h / 2 - 45, 15, 15));
+    layer_set_update_proc(s_forecasticon_layer, forecasticon_update_proc);
+    layer_add_child(window_layer, s_forecasticon_layer);
 
 	// show hands
 	s_hands_layer = layer_create(bounds);
 	layer_set_update_proc(s_hands_layer, hands_update_proc);
 	layer_add_child(window_layer, s_hands_layer);  
 
+	// second hand above hour and minute hands
+	s_seconds_layer = layer_create(bounds);
+	layer_set_update_proc(s_seconds_layer, seconds_update_proc);
+	layer_add_child(window_layer, s_seconds_layer);
+
+	// center box for weather data above all hands
+	s_center_layer = layer_create(bounds);
+	layer_set_update_proc(s_center_layer, center_update_proc);
+	layer_add_child(window_layer, s_center_layer);
+
 	// add current weather icon
-	s_icon_layer = bitmap_layer_create(GRect(bounds.size.w / 2 - 12, bounds.size.h / 2 - 20, 25, 25));
-	layer_add_child(window_layer, bitmap_layer_get_layer(s_icon_layer));
-    if (s_icon_bitmap) {
-        gbitmap_destroy(s_icon_bitmap);
-    }
-    if (settings.reverse == 1) {
-        s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS_REVERSE[cachedWeather.icon_current]);
-    }
-    else {
-        s_icon_bitmap = gbitmap_create_with_resource(WEATHER_ICONS[cachedWeather.icon_current]);
-    }
-    bitmap_layer_set_bitmap(s_icon_layer, s_icon_bitmap);
+	s_icon_layer = layer_create(GRect(bounds.size.w / 2 - 12, bounds.size.h / 2 - 20, 25, 25));
+	layer_set_update_proc(s_icon_layer, icon_update_proc);
+	layer_add_child(window_layer, s_icon_layer);
     
-    // add current temperature label
-	s_temperature_label = text_layer_create(GRect(bounds.size.w / 2 - 12, bounds.size.h / 2 + 2, 30, 21));
-	text_layer_set_text_color(s_temperature_label, color_maintext);
-	text_layer_set_background_color(s_temperature_label, color_maintextbackground);
-	text_layer_set_font(s_temperature_label, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-	text_layer_set_text_alignment(s_temperature_label, GTextAlignmentCenter);
-	layer_add_child(window_layer, text_layer_get_layer(s_temperature_label));
+	// show cached weather, the empty initial record below is ignored
+	weather_show();
+
+    #if DEBUG_PROFILE
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "window load: %d bytes of heap for layers, fonts and bitmaps",
+            (int)(heap_bytes_used() - heap_before));
+    #endif
 
 	// appsync dictionary initial setup
 	// if I don't sync all appkeys, I get sync errors, but no idea why...
+	// the weather record tuple starts zeroed at full size so incoming records fit
+	static const uint8_t empty_record[sizeof(WeatherRecord) + WEATHER_CITY_MAX] = { 0 };
+	static const uint8_t empty_timeline[sizeof(WeatherTimeline)] = { 0 };
 	Tuplet initial_values[] = {
-		TupletInteger(WEATHER_ICON, (uint8_t) cachedWeather.icon_current),
-		TupletCString(WEATHER_TEMPERATURE, cachedWeather.temperature),
-		TupletCString(WEATHER_CITY, cachedWeather.city),
-		TupletCString(WEATHER_SUNTIMES, cachedWeather.suntimes),
-		TupletInteger(WEATHER_FORECASTICON, (uint8_t) cachedWeather.forecasticon),
-		TupletCString(WEATHER_MINMAXTEMP, cachedWeather.minmaxtemp),
-		TupletCString(WEATHER_MISC, cachedWeather.misc),
+		TupletBytes(WEATHER_PACKED, empty_record, sizeof(empty_record)),
+		TupletBytes(WEATHER_TIMELINE, empty_timeline, sizeof(empty_timeline)),
 		TupletInteger(CONFIG_SECONDS, (uint8_t) settings.seconds),
 		TupletInteger(CONFIG_HOURVIBES, (uint8_t) settings.hourvibes),
         TupletInteger(CONFIG_REVERSE, (uint8_t) settings.reverse),
         TupletInteger(CONFIG_DISTANCE, (uint8_t) settings.distance),
-        TupletInteger(CONFIG_BLUETHEME, (uint8_t) settings.bluetheme)
+        TupletInteger(CONFIG_BLUETHEME, (uint8_t) settings.bluetheme),
+        TupletInteger(CONFIG_SECONDSWINDOW, (uint8_t) settings.secondswindow),
+        #if TELEMETRY
+        TupletInteger(TELEMETRY_REQUEST, (uint8_t) 0),
+        #endif
 	};
 
 	app_sync_init(&s_sync, s_sync_buffer, sizeof(s_sync_buffer),
@@ -759,16 +2031,24 @@ static void window_load(Window *window) {
 	  sync_tuple_changed_callback, sync_error_callback, NULL
 	);
 
-	// init status labels
-	handle_battery(battery_state_service_peek());
-	handle_bluetooth(bluetooth_connection_service_peek());
+    // benchmark draws on top of everything, then hides itself
+    #if DEBUG_BENCHMARK
+    s_bench_layer = layer_create(bounds);
+    layer_set_update_proc(s_bench_layer, bench_update_proc);
+    layer_add_child(window_layer, s_bench_layer);
+    #endif
 
   	// get weather on load
     // 	request_weather();
     #if defined(PBL_HEALTH)
-        request_health();
+        // subscribing delivers a significant update with today's totals right away
+        health_service_events_subscribe(handle_health, NULL);
     #endif
 
+	// init status labels, the battery sets the first power stage
+	handle_battery(battery_state_service_peek());
+	handle_bluetooth(bluetooth_connection_service_peek());
+
 }
 
 
@@ -777,35 +2057,27 @@ static void window_load(Window *window) {
 //======================================
 static void window_unload(Window *window) {
     layer_destroy(s_simple_bg_layer);
-    layer_destroy(s_date_layer);
-
-    text_layer_destroy(s_label_12);
-    text_layer_destroy(s_label_4);
-    text_layer_destroy(s_label_8);
-    text_layer_destroy(s_day_label);
-    text_layer_destroy(s_battery_label);
-    text_layer_destroy(s_city_label);
-    text_layer_destroy(s_temperature_label);
-    text_layer_destroy(s_suntimes_label);
-    text_layer_destroy(s_minmaxtemp_label);
-    text_layer_destroy(s_misc_label);
+    layer_destroy(s_info_layer);
 
-    if (s_icon_bitmap) {
-    gbitmap_destroy(s_icon_bitmap);
-    }
-    if (s_forecasticon_bitmap) {
-    gbitmap_destroy(s_forecasticon_bitmap);
-    }
     if (s_bluetooth_bitmap) {
         gbitmap_destroy(s_bluetooth_bitmap);
     }
+    if (s_dial_cache) {
+        gbitmap_destroy(s_dial_cache);
+        s_dial_cache = NULL;
+    }
 
     fonts_unload_custom_font(custom_font_numerals);
 
-    bitmap_layer_destroy(s_icon_layer);
-    bitmap_layer_destroy(s_forecasticon_layer);
+    layer_destroy(s_icon_layer);
+    layer_destroy(s_forecasticon_layer);
     bitmap_layer_destroy(s_bluetooth_layer);
     layer_destroy(s_hands_layer);
+    layer_destroy(s_seconds_layer);
+    layer_destroy(s_center_layer);
+    #if DEBUG_BENCHMARK
+    layer_destroy(s_bench_layer);
+    #endif
 }
 
 
@@ -813,34 +2085,38 @@ static void window_unload(Window *window) {
 // INIT
 //======================================
 static void init() {
-    // load persistent settings from struct
-    if (persist_exists(PERSIST_SETTINGS)) {
-        persist_read_data(PERSIST_SETTINGS, &settings, sizeof(settings));
-    }
-    
-    // load cached data from struct
-    if (persist_exists(PERSIST_WEATHERDATA)) {
-        persist_read_data(PERSIST_WEATHERDATA, &cachedWeather, sizeof(cachedWeather));
+    // load persistent settings and cached weather, older layouts get migrated
+    storage_load(&s_settings_store);
+    storage_load(&s_weather_store);
+    storage_load(&s_timeline_store);
+    s_timeline_shown = weather_timeline_slot(time(NULL)); // the cached labels are newer than the slot
+    frame_time_set(time(NULL)); // until the first tick
+    if (cachedWeather.latitude != SUNTIMES_NO_LOCATION) {
+        suntimes_update(); // the cached sun times may be from another day
     }
     
-    // set second or minute updates
-    if (settings.seconds == 1) {
-        tick_timer_service_subscribe(SECOND_UNIT, handle_time_tick);
-    }
-    else {
-        tick_timer_service_subscribe(MINUTE_UNIT, handle_time_tick);
-    }
+    // periodic jobs go on the wheel before the first tick
+    jobs_start();
+
+    // set second or minute updates, and taps for the seconds window
+    seconds_mode_update();
     
     // set color settings
     color_handler();
 
 	window = window_create();
+	window_set_background_color(window, GColorClear); // frames build on the last one, see bg_update_proc
 	window_set_window_handlers(window, (WindowHandlers) {
 	.load = window_load,
+	.appear = window_appear,
 	.unload = window_unload,
 	});
+	app_focus_service_subscribe_handlers((AppFocusHandlers) {
+	.will_focus = handle_focus, // the system draws the window once before focus is back
+	.did_focus = handle_focus,
+	});
 	window_stack_push(window, true);
-	app_message_open(256, 256);
+	app_message_open(128, 64);
 
 //	s_day_buffer[0] = '\0';
 //    s_battery_buffer[0] = '\0';
@@ -851,9 +2127,9 @@ static void init() {
 //	s_misc_buffer[0] = '\0';
 //	s_city_buffer[0] = '\0';
 
-	// init hand paths
-	s_minute_arrow = gpath_create(&MINUTE_HAND_POINTS);
-	s_hour_arrow = gpath_create(&HOUR_HAND_POINTS);
+	// init hand paths, points get filled in from the pose tables
+	s_minute_arrow = gpath_create(&MINUTE_POSE_INFO);
+	s_hour_arrow = gpath_create(&HOUR_POSE_INFO);
 	Layer *window_layer = window_get_root_layer(window);
 	GRect bounds = layer_get_bounds(window_layer);
 	GPoint center = grect_center_point(&bounds);
@@ -875,9 +2151,8 @@ static void init() {
 // DEINIT
 //======================================
 static void deinit() {
-    // write persists
-    persist_write_data(PERSIST_SETTINGS, &settings, sizeof(settings));
-    persist_write_data(PERSIST_WEATHERDATA, &cachedWeather, sizeof(cachedWeather));
+    // write anything the write-behind is still holding
+    storage_flush_all(true);
 
     app_sync_deinit(&s_sync);
     
@@ -888,6 +2163,12 @@ static void deinit() {
     }
     
     tick_timer_service_unsubscribe();
+    app_focus_service_unsubscribe();
+    accel_tap_service_unsubscribe();
+    scheduler_deinit();
+    #if defined(PBL_HEALTH)
+    health_service_events_unsubscribe();
+    #endif
     battery_state_service_unsubscribe();
     bluetooth_connection_service_unsubscribe();
     window_destroy(window);
@@ -901,4 +2182,5 @@ int main() {
   init();
   app_event_loop();
   deinit();
+  return 0;
 }
@@ -183,6 +183,11 @@ static const GPathInfo HOUR_HAND_POINTS = {
 //    }
 //};
 
+//======================================
+// CURRENT HAND SHAPES
+//======================================
+// not drawn directly: tools/generate_hand_poses.py rotates these into
+// hand_poses.h at build time, so rerun it after changing them
 static const GPathInfo MINUTE_HAND_POINTS = {
     10,
     (GPoint []) {
@@ -0,0 +1,109 @@
+//======================================
+// TECHRAD field telemetry
+// The newest sample is the current hour, older ones are overwritten
+//======================================
+
+#include "telemetry.h"
+
+#if TELEMETRY
+
+#define TELEMETRY_RETRY_MS 200 // outbox poll while a message is in flight
+
+static TelemetrySample s_samples[TELEMETRY_SAMPLES];
+static uint8_t s_head = 0;  // current hour
+static uint8_t s_count = 0; // samples in use
+static AppTimer *s_export_timer = NULL;
+static uint8_t s_export_index = 0;
+
+
+//======================================
+// RING BUFFER
+//======================================
+// sample for this hour, starting a new one when the hour changed
+static TelemetrySample *telemetry_current(void) {
+    uint32_t hour = time(NULL) / 3600;
+    if ((s_count > 0) && (s_samples[s_head].hour == hour)) {
+        return &s_samples[s_head];
+    }
+    if (s_count > 0) {
+        s_head = (s_head + 1) % TELEMETRY_SAMPLES;
+    }
+    if (s_count < TELEMETRY_SAMPLES) {
+        s_count++;
+    }
+    memset(&s_samples[s_head], 0, sizeof(TelemetrySample));
+    s_samples[s_head].hour = hour;
+    return &s_samples[s_head];
+}
+
+static uint32_t telemetry_now_ms(void) {
+    time_t seconds;
+    uint16_t millis;
+    time_ms(&seconds, &millis);
+    return (uint32_t)seconds * 1000 + millis;
+}
+
+uint32_t telemetry_begin(void) {
+    return telemetry_now_ms();
+}
+
+void telemetry_end(TelemetryProbe probe, uint32_t start) {
+    uint32_t ms = telemetry_now_ms() - start;
+    TelemetrySample *sample = telemetry_current();
+    sample->runs[probe]++;
+    sample->ms_total[probe] += ms;
+    if (ms > sample->ms_max[probe]) {
+        sample->ms_max[probe] = (ms > UINT16_MAX) ? UINT16_MAX : ms;
+    }
+    uint32_t heap = heap_bytes_used();
+    if (heap > sample->heap_high_water) {
+        sample->heap_high_water = heap;
+    }
+}
+
+void telemetry_count(TelemetryCounter counter) {
+    telemetry_current()->counters[counter]++;
+}
+
+
+//======================================
+// EXPORT
+//======================================
+// one sample per message, oldest first, the next one goes once the outbox is free
+static void telemetry_export_next(void *data) {
+    s_export_timer = NULL;
+    if (s_export_index >= s_count) {
+        return;
+    }
+
+    DictionaryIterator *iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+        s_export_timer = app_timer_register(TELEMETRY_RETRY_MS, telemetry_export_next, NULL);
+        return;
+    }
+
+    uint8_t oldest = (s_head + TELEMETRY_SAMPLES + 1 - s_count) % TELEMETRY_SAMPLES;
+    uint8_t message[3 + sizeof(TelemetrySample)];
+    message[0] = TELEMETRY_VERSION;
+    message[1] = s_export_index;
+    message[2] = s_count;
+    memcpy(message + 3, &s_samples[(oldest + s_export_index) % TELEMETRY_SAMPLES], sizeof(TelemetrySample));
+    dict_write_data(iter, TELEMETRY_DATA, message, sizeof(message));
+    dict_write_end(iter);
+    app_message_outbox_send();
+    s_samples[s_head].counters[TELEMETRY_MESSAGES_OUT]++;
+
+    s_export_index++;
+    s_export_timer = app_timer_register(TELEMETRY_RETRY_MS, telemetry_export_next, NULL);
+}
+
+void telemetry_export(void) {
+    telemetry_current();
+    if (s_export_timer) { // already sending
+        return;
+    }
+    s_export_index = 0;
+    s_export_timer = app_timer_register(0, telemetry_export_next, NULL);
+}
+
+#endif
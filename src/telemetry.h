@@ -0,0 +1,62 @@
+//======================================
+// TECHRAD field telemetry
+// Hourly frame costs, message and flash counts in a ring buffer
+// sent to the phone on request, see TELEMETRY in pebble-js-app.js
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+// set to 1 to record telemetry, 0 compiles every hook away
+#define TELEMETRY 0
+
+#define TELEMETRY_SAMPLES 24 // hours kept
+#define TELEMETRY_VERSION 1
+
+// message keys, also in appinfo.json
+enum TelemetryKey {
+    TELEMETRY_REQUEST = 0xE,        // TUPLE_INT, phone asks for an export
+    TELEMETRY_DATA = 0xF            // TUPLE_BYTE_ARRAY, version, index, count, TelemetrySample
+};
+
+// timed code paths
+typedef enum {
+    TELEMETRY_BG = 0,
+    TELEMETRY_HANDS,
+    TELEMETRY_DATE,
+    TELEMETRY_SYNC,
+    TELEMETRY_PROBES
+} TelemetryProbe;
+
+typedef enum {
+    TELEMETRY_MESSAGES_IN = 0,      // tuples received
+    TELEMETRY_MESSAGES_OUT,         // messages sent to the phone
+    TELEMETRY_PERSIST_WRITES,       // storage records written
+    TELEMETRY_COUNTERS
+} TelemetryCounter;
+
+// one hour, little endian as sent
+typedef struct TelemetrySample {
+    uint32_t hour;                               // epoch / 3600
+    uint16_t runs[TELEMETRY_PROBES];             // redraws or callbacks
+    uint16_t ms_max[TELEMETRY_PROBES];           // slowest run
+    uint32_t ms_total[TELEMETRY_PROBES];         // all runs
+    uint16_t counters[TELEMETRY_COUNTERS];
+    uint32_t heap_high_water;                    // most heap_bytes_used() seen
+} __attribute__((__packed__)) TelemetrySample;
+
+#if TELEMETRY
+uint32_t telemetry_begin(void);
+void telemetry_end(TelemetryProbe probe, uint32_t start);
+void telemetry_count(TelemetryCounter counter);
+void telemetry_export(void);
+
+#define TELEMETRY_BEGIN(var) uint32_t var = telemetry_begin()
+#define TELEMETRY_END(probe, var) telemetry_end(probe, var)
+#define TELEMETRY_COUNT(counter) telemetry_count(counter)
+#else
+#define TELEMETRY_BEGIN(var)
+#define TELEMETRY_END(probe, var)
+#define TELEMETRY_COUNT(counter)
+#endif
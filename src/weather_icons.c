@@ -0,0 +1,118 @@
+//======================================
+// TECHRAD weather icons
+// Every icon is a list of commands on a 25x25 grid, the size of the big
+// icon. Coordinates and radii are scaled to the frame when drawn.
+// Antialiasing stays off, every pixel of an icon is one of its three
+// theme colors.
+//======================================
+
+#include "weather_icons.h"
+
+#define ICON_GRID 25
+#define ICON_MAX_COMMANDS 9
+
+typedef enum {
+    ICON_END = 0,
+    ICON_CIRCLE,    // a, b center, c radius
+    ICON_ROUNDED,   // a, b origin, c, d size, corners rounded by half the height
+    ICON_LINE       // a, b to c, d
+} IconCommandType;
+
+typedef enum {
+    ICON_SUN = 0,
+    ICON_CLOUD,
+    ICON_ACCENT
+} IconColor;
+
+typedef struct IconCommand {
+    uint8_t type;   // IconCommandType
+    uint8_t color;  // IconColor
+    int8_t a, b, c, d;
+} IconCommand;
+
+static const IconCommand ICONS[WEATHER_ICON_COUNT][ICON_MAX_COMMANDS] = {
+    [WEATHER_ICON_SUN] = {
+        { ICON_CIRCLE, ICON_SUN, 12, 12, 6, 0 },
+        { ICON_LINE, ICON_SUN, 12, 0, 12, 3 },
+        { ICON_LINE, ICON_SUN, 12, 21, 12, 24 },
+        { ICON_LINE, ICON_SUN, 0, 12, 3, 12 },
+        { ICON_LINE, ICON_SUN, 21, 12, 24, 12 },
+        { ICON_LINE, ICON_SUN, 3, 3, 5, 5 },
+        { ICON_LINE, ICON_SUN, 19, 19, 21, 21 },
+        { ICON_LINE, ICON_SUN, 21, 3, 19, 5 },
+        { ICON_LINE, ICON_SUN, 3, 21, 5, 19 }
+    },
+    [WEATHER_ICON_CLOUD] = {
+        { ICON_CIRCLE, ICON_ACCENT, 16, 4, 4, 0 },
+        { ICON_ROUNDED, ICON_ACCENT, 7, 3, 18, 8 },
+        { ICON_CIRCLE, ICON_CLOUD, 12, 15, 5, 0 },
+        { ICON_ROUNDED, ICON_CLOUD, 0, 16, 25, 9 }
+    },
+    [WEATHER_ICON_RAIN] = {
+        { ICON_CIRCLE, ICON_CLOUD, 11, 5, 5, 0 },
+        { ICON_ROUNDED, ICON_CLOUD, 0, 4, 25, 9 },
+        { ICON_LINE, ICON_ACCENT, 4, 15, 2, 23 },
+        { ICON_LINE, ICON_ACCENT, 9, 15, 7, 23 },
+        { ICON_LINE, ICON_ACCENT, 14, 15, 12, 20 },
+        { ICON_LINE, ICON_ACCENT, 19, 15, 17, 20 }
+    },
+    [WEATHER_ICON_SNOW] = {
+        { ICON_LINE, ICON_CLOUD, 12, 3, 12, 21 },
+        { ICON_LINE, ICON_CLOUD, 4, 7, 20, 17 },
+        { ICON_LINE, ICON_CLOUD, 4, 17, 20, 7 }
+    },
+    [WEATHER_ICON_LOADING] = {
+        { ICON_CIRCLE, ICON_SUN, 5, 12, 2, 0 },
+        { ICON_CIRCLE, ICON_SUN, 12, 12, 2, 0 },
+        { ICON_CIRCLE, ICON_SUN, 19, 12, 2, 0 }
+    }
+};
+
+
+//======================================
+// DRAWING
+//======================================
+static int16_t icon_scale(int8_t value, int16_t size) {
+    return (value * size + ICON_GRID / 2) / ICON_GRID;
+}
+
+static GPoint icon_point(GRect frame, int8_t x, int8_t y) {
+    return GPoint(frame.origin.x + icon_scale(x, frame.size.w), frame.origin.y + icon_scale(y, frame.size.h));
+}
+
+void weather_icon_draw(GContext *ctx, GRect frame, uint8_t icon, const WeatherIconColors *colors) {
+    if (icon >= WEATHER_ICON_COUNT) {
+        icon = WEATHER_ICON_LOADING;
+    }
+    const GColor palette[] = { colors->sun, colors->cloud, colors->accent };
+
+    graphics_context_set_antialiased(ctx, false);
+    #ifdef PBL_PLATFORM_BASALT
+        graphics_context_set_stroke_width(ctx, (frame.size.w >= ICON_GRID) ? 2 : 1);
+    #endif
+
+    for (const IconCommand *command = ICONS[icon]; command < ICONS[icon] + ICON_MAX_COMMANDS; ++command) {
+        GColor color = palette[command->color];
+        switch (command->type) {
+        case ICON_CIRCLE: {
+            int16_t radius = icon_scale(command->c, frame.size.w);
+            graphics_context_set_fill_color(ctx, color);
+            graphics_fill_circle(ctx, icon_point(frame, command->a, command->b), (radius > 0) ? radius : 1);
+            break;
+        }
+        case ICON_ROUNDED: {
+            GPoint origin = icon_point(frame, command->a, command->b);
+            GRect rect = GRect(origin.x, origin.y, icon_scale(command->c, frame.size.w), icon_scale(command->d, frame.size.h));
+            graphics_context_set_fill_color(ctx, color);
+            graphics_fill_rect(ctx, rect, rect.size.h / 2, GCornersAll);
+            break;
+        }
+        case ICON_LINE:
+            graphics_context_set_stroke_color(ctx, color);
+            graphics_draw_line(ctx, icon_point(frame, command->a, command->b), icon_point(frame, command->c, command->d));
+            break;
+        default:
+            return; // ICON_END
+        }
+    }
+}
@@ -0,0 +1,28 @@
+//======================================
+// TECHRAD weather icons
+// Drawn from a short list of vector commands at any size,
+// colored by the theme when they are drawn
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+// icon ids sent by the phone
+enum WeatherIconId {
+    WEATHER_ICON_SUN = 0,
+    WEATHER_ICON_CLOUD,
+    WEATHER_ICON_RAIN,
+    WEATHER_ICON_SNOW,
+    WEATHER_ICON_LOADING,
+    WEATHER_ICON_COUNT
+};
+
+typedef struct WeatherIconColors {
+    GColor sun;     // sun and loading dots
+    GColor cloud;   // clouds and snow
+    GColor accent;  // rain drops and the cloud behind
+} WeatherIconColors;
+
+// icon scaled to fill frame, unknown ids draw the loading icon
+void weather_icon_draw(GContext *ctx, GRect frame, uint8_t icon, const WeatherIconColors *colors);
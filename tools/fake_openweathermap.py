@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+#
+# TECHRAD stand-in OpenWeatherMap server
+# Serves canned /weather and /forecast answers so the fetch pipeline in
+# pebble-js-app.js can be timed and broken on purpose without the real API.
+#
+# Point the phone at it by setting "weather_api_base" in the app's
+# localStorage, e.g. to "http://192.168.1.10:8080/data/2.5/".
+#
+# usage: fake_openweathermap.py [--port 8080] [--delay-weather S] [--delay-forecast S]
+#                               [--fail weather|forecast] [--not-found]
+#
+
+import argparse
+import json
+import time
+
+try:
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+except ImportError:
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+
+WEATHER = {
+    'cod': 200, 'name': 'Fakeville', 'dt': 0,
+    'coord': {'lat': 51.51, 'lon': -0.13},
+    'main': {'temp': 285.15},
+    'wind': {'speed': 4.2},
+    'weather': [{'id': 801}],
+    'sys': {'sunrise': 0, 'sunset': 0},
+}
+
+
+def forecast(count):
+    # 3 hour steps from the next boundary, like the real endpoint
+    start = (int(time.time()) // 10800 + 1) * 10800
+    return {
+        'cod': '200',
+        'list': [{'dt': start + i * 10800,
+                  'main': {'temp': 284.15 + i % 4, 'temp_min': 280.15 + i % 4, 'temp_max': 288.15 + i % 4},
+                  'wind': {'speed': 3.0 + i % 3},
+                  'weather': [{'id': (500, 800, 801)[i % 3]}]}
+                 for i in range(count)],
+    }
+
+
+def make_handler(args):
+    class Handler(BaseHTTPRequestHandler):
+        def do_GET(self):
+            path = self.path.split('?')[0]
+            if path.endswith('/weather'):
+                name, delay, body = 'weather', args.delay_weather, dict(WEATHER)
+                now = int(time.time())
+                body.update(dt=now, sys={'sunrise': now - 6 * 3600, 'sunset': now + 6 * 3600})
+            elif path.endswith('/forecast'):
+                cnt = [p[4:] for p in self.path.split('?')[-1].split('&') if p.startswith('cnt=')]
+                name, delay, body = 'forecast', args.delay_forecast, forecast(int(cnt[0]) if cnt else 40)
+            else:
+                self.send_error(400)
+                return
+
+            time.sleep(delay)
+            if args.fail == name:
+                self.send_error(500)
+                return
+            if args.not_found:
+                self.send_response(404)
+                body = {'cod': '404', 'message': 'city not found'}
+            else:
+                self.send_response(200)
+            data = json.dumps(body).encode('utf-8')
+            self.send_header('Content-Type', 'application/json')
+            self.send_header('Content-Length', str(len(data)))
+            self.end_headers()
+            self.wfile.write(data)
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description='stand-in OpenWeatherMap server')
+    parser.add_argument('--port', type=int, default=8080)
+    parser.add_argument('--delay-weather', type=float, default=0.0, help='seconds before /weather answers')
+    parser.add_argument('--delay-forecast', type=float, default=0.0, help='seconds before /forecast answers')
+    parser.add_argument('--fail', choices=['weather', 'forecast'], help='answer this one with HTTP 500')
+    parser.add_argument('--not-found', action='store_true', help='answer everything with 404 city not found')
+    args = parser.parse_args()
+
+    server = HTTPServer(('', args.port), make_handler(args))
+    print('serving on port %d' % args.port)
+    server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
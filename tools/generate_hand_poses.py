@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+#
+# TECHRAD hand pose generator
+# Reads MINUTE_HAND_POINTS and HOUR_HAND_POINTS from src/techrad.h and writes
+# every rotation the watch face needs into src/hand_poses.h, so the hands are
+# a table lookup at draw time instead of a trig rotation.
+#
+# usage: generate_hand_poses.py src/techrad.h src/hand_poses.h
+#
+
+import math
+import re
+import sys
+
+MINUTE_POSES = 60          # one pose per minute
+HOUR_POSES = 12 * 12       # one pose every 5 minutes
+SECOND_POSES = 60          # one endpoint per second
+SECOND_HAND_LENGTH = 84    # half the screen height, as drawn on the watch
+
+# Pebble trig: angles are 0..TRIG_MAX_ANGLE, ratios are 0..TRIG_MAX_RATIO
+TRIG_MAX_ANGLE = 0x10000
+TRIG_MAX_RATIO = 0xffff
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def read_path(text, name):
+    match = re.search(r'GPathInfo\s+' + name + r'\s*=\s*\{\s*(\d+)\s*,\s*\(GPoint\s*\[\]\)\s*\{(.*?)\}\s*\}\s*;', text, re.S)
+    if not match:
+        raise SystemExit('could not find %s' % name)
+    points = [(int(x), int(y)) for x, y in re.findall(r'\{\s*(-?\d+)\s*,\s*(-?\d+)\s*\}', match.group(2))]
+    if len(points) != int(match.group(1)):
+        raise SystemExit('%s declares %s points but lists %d' % (name, match.group(1), len(points)))
+    return points
+
+
+def trig(angle):
+    radians = 2 * math.pi * angle / TRIG_MAX_ANGLE
+    return int(round(math.sin(radians) * TRIG_MAX_RATIO)), int(round(math.cos(radians) * TRIG_MAX_RATIO))
+
+
+def rotate(points, angle):
+    # same transform as gpath_rotate_to, rounded instead of truncated
+    sine, cosine = trig(angle)
+    pose = []
+    for x, y in points:
+        rx = int(round(float(x * cosine - y * sine) / TRIG_MAX_RATIO))
+        ry = int(round(float(x * sine + y * cosine) / TRIG_MAX_RATIO))
+        if not (-128 <= rx <= 127 and -128 <= ry <= 127):
+            raise SystemExit('hand point (%d, %d) does not fit in int8_t' % (x, y))
+        pose.append((rx, ry))
+    return pose
+
+
+def format_pose(pose):
+    return '{ ' + ', '.join('{ %d, %d }' % p for p in pose) + ' }'
+
+
+def main(source, target):
+    text = strip_comments(open(source).read())
+    minute = read_path(text, 'MINUTE_HAND_POINTS')
+    hour = read_path(text, 'HOUR_HAND_POINTS')
+
+    out = []
+    out.append('// generated by tools/generate_hand_poses.py from techrad.h, do not edit')
+    out.append('// hand points are offsets from the screen center, already rotated')
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('#include "pebble.h"')
+    out.append('')
+    out.append('#define MINUTE_HAND_POSE_POINTS %d' % len(minute))
+    out.append('#define HOUR_HAND_POSE_POINTS %d' % len(hour))
+    out.append('#define MINUTE_HAND_POSES %d' % MINUTE_POSES)
+    out.append('#define HOUR_HAND_POSES %d // index is (hour %% 12) * 12 + minute / 5' % HOUR_POSES)
+    out.append('#define SECOND_HAND_POSES %d' % SECOND_POSES)
+    out.append('')
+
+    out.append('static const int8_t MINUTE_HAND_POSE[MINUTE_HAND_POSES][MINUTE_HAND_POSE_POINTS][2] = {')
+    for i in range(MINUTE_POSES):
+        out.append('  %s, // %d' % (format_pose(rotate(minute, TRIG_MAX_ANGLE * i // MINUTE_POSES)), i))
+    out.append('};')
+    out.append('')
+
+    out.append('static const int8_t HOUR_HAND_POSE[HOUR_HAND_POSES][HOUR_HAND_POSE_POINTS][2] = {')
+    for i in range(HOUR_POSES):
+        out.append('  %s, // %d:%02d' % (format_pose(rotate(hour, TRIG_MAX_ANGLE * i // HOUR_POSES)), i // 12, (i % 12) * 5))
+    out.append('};')
+    out.append('')
+
+    out.append('static const int8_t SECOND_HAND_POSE[SECOND_HAND_POSES][2] = {')
+    for i in range(SECOND_POSES):
+        out.append('  %s, // %d' % (format_pose(rotate([(0, -SECOND_HAND_LENGTH)], TRIG_MAX_ANGLE * i // SECOND_POSES))[2:-2], i))
+    out.append('};')
+    out.append('')
+
+    with open(target, 'w') as f:
+        f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        raise SystemExit('usage: %s techrad.h hand_poses.h' % sys.argv[0])
+    main(sys.argv[1], sys.argv[2])
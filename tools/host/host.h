@@ -0,0 +1,101 @@
+//======================================
+// TECHRAD host build
+// Controls for the host tests and the host run of the face: the fake
+// clock, service events from the "system", the phone side of AppSync
+// and access to the frame buffer the layers draw into
+//======================================
+
+#pragma once
+
+#include "pebble.h"
+
+#define HOST_SCREEN_W 144
+#define HOST_SCREEN_H 168
+
+//======================================
+// FRAMES
+//======================================
+// 144x168 screen, 8 bit GColor8 on color platforms, 1 bit with 20 byte rows on aplite
+GBitmap *host_frame_buffer(void);
+
+// draw the window if any layer was marked dirty, the whole layer tree
+// like the system does, returns false if nothing was dirty
+bool host_render(void);
+
+// frames drawn since start
+uint32_t host_frames(void);
+
+// GColorWhite or GColorBlack on 1 bit bitmaps
+GColor host_pixel(const GBitmap *bitmap, int16_t x, int16_t y);
+
+// independent copy of a bitmap, free with gbitmap_destroy
+GBitmap *host_bitmap_copy(const GBitmap *bitmap);
+
+// pixels that differ between two bitmaps of the same size and format
+// the first one goes to first if that isn't NULL
+uint32_t host_bitmap_diff(const GBitmap *a, const GBitmap *b, GPoint *first);
+
+// fill the frame buffer with a pattern no proc draws, stale pixels show up against it
+void host_frame_buffer_scribble(void);
+
+// rect of the bitmap as text, one character per pixel from palette by
+// pixel value (the argb byte, or 0/1 on aplite), '?' for values past its end
+void host_bitmap_ascii(FILE *out, const GBitmap *bitmap, GRect rect, const char *palette);
+
+// binary PPM of the bitmap, returns false if the file can't be written
+bool host_bitmap_write_ppm(const char *path, const GBitmap *bitmap);
+
+
+//======================================
+// CLOCK
+//======================================
+// set the clock without ticking, the face sees it on the next time() call
+void host_time_set(time_t now);
+
+// run the clock forward a second at a time: timers fire when due, the tick
+// handler gets every unit it subscribed to that changed, and the window is
+// drawn after every event like on the watch
+void host_advance(uint32_t seconds);
+
+// fire the timers that are due at the current time
+void host_timers_run(void);
+
+void host_clock_24h_set(bool clock24);
+
+
+//======================================
+// SERVICES
+//======================================
+void host_battery_set(BatteryChargeState state);
+void host_bluetooth_set(bool connected);
+void host_tap(void);
+
+// today's totals the health service reports, and how often they were asked for
+void host_health_set(HealthMetric metric, HealthValue value);
+void host_health_event(HealthEventType event);
+uint32_t host_health_queries(void);
+
+// a system window or notification covers the app and draws over the frame buffer
+// while it is shown, hiding it gives the app focus back and draws the window
+void host_overlay_show(void);
+void host_overlay_hide(void);
+
+// the phone changes an AppSync value
+void host_sync_update(const Tuplet *tuplet);
+
+// the next persist_read_data returns at most bytes, like a read cut short
+void host_persist_short_read(int bytes);
+
+uint32_t host_messages_sent(void);
+uint32_t host_vibes(void);
+
+
+//======================================
+// TESTS
+//======================================
+// a failed check is reported and counted, the test carries on
+#define HOST_CHECK(condition) host_check((condition), __FILE__, __LINE__, #condition)
+bool host_check(bool ok, const char *file, int line, const char *expression);
+
+// summary line for the test, returns its exit status
+int host_test_result(const char *name);
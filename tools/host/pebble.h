@@ -0,0 +1,419 @@
+//======================================
+// TECHRAD host build
+// Stand-in for the parts of the Pebble SDK 3 header the face uses,
+// so src/ builds and runs on Linux, see pebble_shim.c and Makefile
+// Types and names follow the SDK, drawing is close but not pixel exact
+//======================================
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+//======================================
+// GEOMETRY
+//======================================
+typedef struct GPoint { int16_t x, y; } GPoint;
+typedef struct GSize { int16_t w, h; } GSize;
+typedef struct GRect { GPoint origin; GSize size; } GRect;
+
+#define GPoint(x, y) ((GPoint){ (x), (y) })
+#define GSize(w, h) ((GSize){ (w), (h) })
+#define GRect(x, y, w, h) ((GRect){ { (x), (y) }, { (w), (h) } })
+#define GPointZero GPoint(0, 0)
+#define GRectZero GRect(0, 0, 0, 0)
+
+GPoint grect_center_point(const GRect *rect);
+bool grect_equal(const GRect *a, const GRect *b);
+void grect_clip(GRect *rect, const GRect *clipper);
+
+#define TRIG_MAX_ANGLE 0x10000
+#define TRIG_MAX_RATIO 0xffff
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+
+//======================================
+// COLORS
+//======================================
+// 2 bits each of alpha, red, green, blue like the SDK's GColor8
+typedef union GColor8 {
+    uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorClearARGB8 ((uint8_t)0x00)
+#define GColorBlackARGB8 ((uint8_t)0xC0)
+#define GColorDukeBlueARGB8 ((uint8_t)0xC2)
+#define GColorBlueARGB8 ((uint8_t)0xC3)
+#define GColorBlueMoonARGB8 ((uint8_t)0xC7)
+#define GColorVividCeruleanARGB8 ((uint8_t)0xCB)
+#define GColorDarkGrayARGB8 ((uint8_t)0xD5)
+#define GColorElectricBlueARGB8 ((uint8_t)0xDF)
+#define GColorRedARGB8 ((uint8_t)0xF0)
+#define GColorOrangeARGB8 ((uint8_t)0xF4)
+#define GColorChromeYellowARGB8 ((uint8_t)0xF8)
+#define GColorPastelYellowARGB8 ((uint8_t)0xFE)
+#define GColorWhiteARGB8 ((uint8_t)0xFF)
+
+#define GColorClear ((GColor8){ .argb = GColorClearARGB8 })
+#define GColorBlack ((GColor8){ .argb = GColorBlackARGB8 })
+#define GColorWhite ((GColor8){ .argb = GColorWhiteARGB8 })
+#define GColorRed ((GColor8){ .argb = GColorRedARGB8 })
+#define GColorBlue ((GColor8){ .argb = GColorBlueARGB8 })
+#define GColorBlueMoon ((GColor8){ .argb = GColorBlueMoonARGB8 })
+#define GColorVividCerulean ((GColor8){ .argb = GColorVividCeruleanARGB8 })
+#define GColorChromeYellow ((GColor8){ .argb = GColorChromeYellowARGB8 })
+#define GColorDarkGray ((GColor8){ .argb = GColorDarkGrayARGB8 })
+
+#ifdef PBL_COLOR
+#define COLOR_FALLBACK(color, bw) (color)
+#define PBL_IF_COLOR_ELSE(color, bw) (color)
+#else
+#define COLOR_FALLBACK(color, bw) (bw)
+#define PBL_IF_COLOR_ELSE(color, bw) (bw)
+#endif
+
+bool gcolor_equal(GColor8 a, GColor8 b);
+
+
+//======================================
+// BITMAPS
+//======================================
+typedef enum {
+    GBitmapFormat1Bit = 0,
+    GBitmapFormat8Bit,
+    GBitmapFormat1BitPalette,
+    GBitmapFormat2BitPalette,
+    GBitmapFormat4BitPalette
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base, GRect sub_rect);
+void gbitmap_destroy(GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+
+
+//======================================
+// GRAPHICS
+//======================================
+typedef struct GContext GContext;
+typedef struct FontInfo *GFont;
+
+typedef enum { GCornerNone = 0, GCornersAll = 15 } GCornerMask;
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+typedef enum { GTextOverflowModeWordWrap, GTextOverflowModeTrailingEllipsis, GTextOverflowModeFill } GTextOverflowMode;
+typedef enum { GCompOpAssign, GCompOpAssignInverted, GCompOpOr, GCompOpAnd, GCompOpClear, GCompOpSet } GCompOp;
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t width);
+void graphics_context_set_antialiased(GContext *ctx, bool enable);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corners);
+void graphics_draw_rect(GContext *ctx, GRect rect);
+void graphics_draw_round_rect(GContext *ctx, GRect rect, uint16_t radius);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_draw_pixel(GContext *ctx, GPoint point);
+void graphics_fill_circle(GContext *ctx, GPoint center, uint16_t radius);
+void graphics_draw_circle(GContext *ctx, GPoint center, uint16_t radius);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow, GTextAlignment alignment, void *attributes);
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+typedef struct GPathInfo {
+    uint32_t num_points;
+    GPoint *points;
+} GPathInfo;
+
+typedef struct GPath {
+    uint32_t num_points;
+    GPoint *points;
+    int32_t rotation;
+    GPoint offset;
+} GPath;
+
+GPath *gpath_create(const GPathInfo *init);
+void gpath_destroy(GPath *path);
+void gpath_rotate_to(GPath *path, int32_t angle);
+void gpath_move_to(GPath *path, GPoint point);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void gpath_draw_outline(GContext *ctx, GPath *path);
+
+
+//======================================
+// FONTS AND RESOURCES
+//======================================
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_BITHAM_34_MEDIUM_NUMBERS "RESOURCE_ID_BITHAM_34_MEDIUM_NUMBERS"
+
+// resource ids from appinfo.json, the shim knows their sizes
+#define RESOURCE_ID_FONT_ROUNDY_34_BOLD 1
+#define RESOURCE_ID_IMAGE_BLUETOOTH 2
+
+typedef void *ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle handle);
+
+GFont fonts_get_system_font(const char *font_key);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+
+//======================================
+// LAYERS AND WINDOWS
+//======================================
+typedef struct Layer Layer;
+typedef struct Window Window;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void *layer_get_data(const Layer *layer);
+void layer_destroy(Layer *layer);
+void layer_mark_dirty(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+GRect layer_get_frame(const Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+void layer_set_hidden(Layer *layer, bool hidden);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode);
+
+typedef void (*WindowHandler)(Window *window);
+typedef struct WindowHandlers {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_background_color(Window *window, GColor color);
+void window_stack_push(Window *window, bool animated);
+
+
+//======================================
+// TIME
+//======================================
+// time() is the shim's clock so tests can set it, localtime runs in UTC
+time_t shim_time(time_t *tloc);
+#define time(tloc) shim_time(tloc)
+
+typedef enum {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+    MONTH_UNIT = 1 << 4,
+    YEAR_UNIT = 1 << 5
+} TimeUnits;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+time_t time_start_of_today(void);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+bool clock_is_24h_style(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer);
+
+
+//======================================
+// SERVICES
+//======================================
+typedef struct BatteryChargeState {
+    uint8_t charge_percent;
+    bool is_charging;
+    bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+typedef void (*BluetoothConnectionHandler)(bool connected);
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler);
+void bluetooth_connection_service_unsubscribe(void);
+bool bluetooth_connection_service_peek(void);
+
+typedef enum { ACCEL_AXIS_X, ACCEL_AXIS_Y, ACCEL_AXIS_Z } AccelAxisType;
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+
+typedef void (*AppFocusHandler)(bool in_focus);
+typedef struct AppFocusHandlers {
+    AppFocusHandler will_focus;
+    AppFocusHandler did_focus;
+} AppFocusHandlers;
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers);
+void app_focus_service_subscribe(AppFocusHandler handler);
+void app_focus_service_unsubscribe(void);
+
+void vibes_short_pulse(void);
+void vibes_long_pulse(void);
+void vibes_double_pulse(void);
+
+typedef enum {
+    HealthMetricStepCount,
+    HealthMetricActiveSeconds,
+    HealthMetricWalkedDistanceMeters,
+    HealthMetricCount
+} HealthMetric;
+typedef enum { HealthServiceAccessibilityMaskAvailable = 1 } HealthServiceAccessibilityMask;
+typedef int32_t HealthValue;
+typedef enum { HealthEventSignificantUpdate, HealthEventMovementUpdate, HealthEventSleepUpdate } HealthEventType;
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t time_start, time_t time_end);
+HealthValue health_service_sum_today(HealthMetric metric);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+
+
+//======================================
+// STORAGE AND MEMORY
+//======================================
+typedef int32_t status_t;
+#define S_SUCCESS 0
+#define E_DOES_NOT_EXIST (-9)
+#define PERSIST_DATA_MAX_LENGTH 256
+
+bool persist_exists(uint32_t key);
+int persist_get_size(uint32_t key);
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+status_t persist_delete(uint32_t key);
+
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+
+
+//======================================
+// MESSAGES
+//======================================
+typedef enum { TUPLE_BYTE_ARRAY = 0, TUPLE_CSTRING = 1, TUPLE_UINT = 2, TUPLE_INT = 3 } TupleType;
+
+typedef struct __attribute__((__packed__)) Tuple {
+    uint32_t key;
+    TupleType type:8;
+    uint16_t length;
+    union {
+        uint8_t data[0];
+        char cstring[0];
+        uint8_t uint8;
+        uint16_t uint16;
+        uint32_t uint32;
+        int8_t int8;
+        int16_t int16;
+        int32_t int32;
+    } value[];
+} Tuple;
+
+typedef struct Tuplet {
+    TupleType type;
+    uint32_t key;
+    union {
+        struct { const uint8_t *data; uint16_t length; } bytes;
+        struct { const char *data; uint16_t length; } cstring;
+        struct { uint32_t storage; uint16_t width; } integer;
+    };
+} Tuplet;
+
+#define TupletBytes(_key, _data, _length) \
+    ((const Tuplet){ .type = TUPLE_BYTE_ARRAY, .key = _key, .bytes = { .data = _data, .length = _length } })
+#define TupletCString(_key, _cstring) \
+    ((const Tuplet){ .type = TUPLE_CSTRING, .key = _key, .cstring = { .data = _cstring, .length = _cstring ? strlen(_cstring) + 1 : 0 } })
+#define TupletInteger(_key, _integer) \
+    ((const Tuplet){ .type = TUPLE_INT, .key = _key, .integer = { .storage = _integer, .width = sizeof(_integer) } })
+
+typedef struct DictionaryIterator DictionaryIterator;
+typedef enum { DICT_OK = 0, DICT_NOT_ENOUGH_STORAGE = 1 << 1, DICT_INVALID_ARGS = 1 << 2 } DictionaryResult;
+typedef enum { APP_MSG_OK = 0, APP_MSG_BUSY = 1 << 10 } AppMessageResult;
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, uint32_t key, const uint8_t *data, uint16_t size);
+DictionaryResult dict_write_int(DictionaryIterator *iter, uint32_t key, const void *integer, uint8_t width, bool is_signed);
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value);
+uint32_t dict_write_end(DictionaryIterator *iter);
+uint32_t dict_calc_buffer_size(uint8_t tuple_count, ...);
+
+AppMessageResult app_message_open(uint32_t size_inbound, uint32_t size_outbound);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+
+typedef void (*AppSyncTupleChangedCallback)(const uint32_t key, const Tuple *new_tuple, const Tuple *old_tuple, void *context);
+typedef void (*AppSyncErrorCallback)(DictionaryResult dict_error, AppMessageResult app_message_error, void *context);
+typedef struct AppSync {
+    AppSyncTupleChangedCallback tuple_changed;
+    AppSyncErrorCallback error;
+    void *context;
+} AppSync;
+void app_sync_init(AppSync *s, uint8_t *buffer, const uint16_t buffer_size, const Tuplet *const keys_and_initial_values,
+                   const uint8_t count, AppSyncTupleChangedCallback tuple_changed_callback,
+                   AppSyncErrorCallback error_callback, void *context);
+void app_sync_deinit(AppSync *s);
+
+
+//======================================
+// APP
+//======================================
+typedef enum {
+    APP_LOG_LEVEL_ERROR = 1,
+    APP_LOG_LEVEL_WARNING = 50,
+    APP_LOG_LEVEL_INFO = 100,
+    APP_LOG_LEVEL_DEBUG = 200
+} AppLogLevel;
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, args...) app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+void app_event_loop(void);
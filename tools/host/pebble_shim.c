@@ -0,0 +1,1554 @@
+//======================================
+// TECHRAD host build
+// Software version of the SDK calls the face makes: a frame buffer
+// the layer tree draws into, a clock the tests move, and services
+// that only do something when host.h says so
+// Drawing follows the SDK's rules closely enough to compare frames
+// against each other, text is drawn as one block per character
+//======================================
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdarg.h>
+#include "host.h"
+
+#ifdef PBL_COLOR
+#define HOST_HEAP_SIZE (64 * 1024)
+#else
+#define HOST_HEAP_SIZE (24 * 1024)
+#endif
+
+#define HOST_PERSIST_KEYS 32
+#define HOST_TIMERS 16
+
+
+//======================================
+// HEAP
+//======================================
+// everything the SDK would allocate on the app heap is counted here
+static size_t s_heap_used;
+
+typedef struct HeapBlock {
+    size_t size;
+    long double data[]; // aligned for anything
+} HeapBlock;
+
+static void *heap_alloc(size_t size) {
+    HeapBlock *block = calloc(1, sizeof(HeapBlock) + size);
+    if (!block) {
+        return NULL;
+    }
+    block->size = size;
+    s_heap_used += size;
+    return block->data;
+}
+
+static void heap_free(void *data) {
+    if (!data) {
+        return;
+    }
+    HeapBlock *block = (HeapBlock *)((uint8_t *)data - offsetof(HeapBlock, data));
+    s_heap_used -= block->size;
+    free(block);
+}
+
+size_t heap_bytes_used(void) {
+    return s_heap_used;
+}
+
+size_t heap_bytes_free(void) {
+    return (s_heap_used < HOST_HEAP_SIZE) ? HOST_HEAP_SIZE - s_heap_used : 0;
+}
+
+
+//======================================
+// GEOMETRY
+//======================================
+GPoint grect_center_point(const GRect *rect) {
+    return GPoint(rect->origin.x + rect->size.w / 2, rect->origin.y + rect->size.h / 2);
+}
+
+bool grect_equal(const GRect *a, const GRect *b) {
+    return memcmp(a, b, sizeof(GRect)) == 0;
+}
+
+void grect_clip(GRect *rect, const GRect *clipper) {
+    int16_t x0 = (rect->origin.x > clipper->origin.x) ? rect->origin.x : clipper->origin.x;
+    int16_t y0 = (rect->origin.y > clipper->origin.y) ? rect->origin.y : clipper->origin.y;
+    int16_t x1 = rect->origin.x + rect->size.w, y1 = rect->origin.y + rect->size.h;
+    int16_t cx1 = clipper->origin.x + clipper->size.w, cy1 = clipper->origin.y + clipper->size.h;
+    x1 = (x1 < cx1) ? x1 : cx1;
+    y1 = (y1 < cy1) ? y1 : cy1;
+    *rect = GRect(x0, y0, (x1 > x0) ? x1 - x0 : 0, (y1 > y0) ? y1 - y0 : 0);
+}
+
+int32_t sin_lookup(int32_t angle) {
+    return (int32_t)lround(sin(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+    return (int32_t)lround(cos(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+    double angle = atan2(y, x);
+    if (angle < 0) {
+        angle += 2.0 * M_PI;
+    }
+    return (int32_t)lround(angle * TRIG_MAX_ANGLE / (2.0 * M_PI)) % TRIG_MAX_ANGLE;
+}
+
+bool gcolor_equal(GColor8 a, GColor8 b) {
+    return a.argb == b.argb;
+}
+
+
+//======================================
+// BITMAPS
+//======================================
+struct GBitmap {
+    uint8_t *data;
+    uint16_t stride;
+    GBitmapFormat format;
+    GRect bounds;
+    bool owns_data;
+};
+
+#ifdef PBL_COLOR
+#define HOST_SCREEN_FORMAT GBitmapFormat8Bit
+#else
+#define HOST_SCREEN_FORMAT GBitmapFormat1Bit
+#endif
+
+static uint16_t bitmap_stride(GSize size, GBitmapFormat format) {
+    return (format == GBitmapFormat8Bit) ? size.w : ((size.w + 31) / 32) * 4;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+    if ((format != GBitmapFormat1Bit) && (format != GBitmapFormat8Bit)) {
+        return NULL;
+    }
+    GBitmap *bitmap = heap_alloc(sizeof(GBitmap));
+    if (!bitmap) {
+        return NULL;
+    }
+    bitmap->stride = bitmap_stride(size, format);
+    bitmap->data = heap_alloc(bitmap->stride * size.h);
+    if (!bitmap->data) {
+        heap_free(bitmap);
+        return NULL;
+    }
+    bitmap->format = format;
+    bitmap->bounds = GRect(0, 0, size.w, size.h);
+    bitmap->owns_data = true;
+    return bitmap;
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base, GRect sub_rect) {
+    GBitmap *bitmap = heap_alloc(sizeof(GBitmap));
+    if (!bitmap) {
+        return NULL;
+    }
+    *bitmap = *base;
+    grect_clip(&sub_rect, &base->bounds);
+    bitmap->bounds = sub_rect;
+    bitmap->owns_data = false;
+    return bitmap;
+}
+
+// bluetooth mark: a bar with two arrow heads, set pixels on a clear background
+static const char *const BLUETOOTH_IMAGE[] = {
+    "....#.....", "....##....", "....#.#...", "#...#..#..", ".#..#.#...",
+    "..#.##....", "...##.....", "....#.....", "...##.....", "..#.##....",
+    ".#..#.#...", "#...#..#..", "....#.#...", "....##....", "....#....."
+};
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+    if (resource_id != RESOURCE_ID_IMAGE_BLUETOOTH) {
+        return NULL;
+    }
+    GBitmap *bitmap = gbitmap_create_blank(GSize(10, ARRAY_LENGTH(BLUETOOTH_IMAGE)), HOST_SCREEN_FORMAT);
+    if (!bitmap) {
+        return NULL;
+    }
+    for (int16_t y = 0; y < bitmap->bounds.size.h; ++y) {
+        for (int16_t x = 0; x < bitmap->bounds.size.w; ++x) {
+            if (BLUETOOTH_IMAGE[y][x] != '#') {
+                continue;
+            }
+            if (bitmap->format == GBitmapFormat8Bit) {
+                bitmap->data[y * bitmap->stride + x] = GColorWhiteARGB8;
+            }
+            else {
+                bitmap->data[y * bitmap->stride + x / 8] |= 1 << (x % 8);
+            }
+        }
+    }
+    return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+    if (!bitmap) {
+        return;
+    }
+    if (bitmap->owns_data) {
+        heap_free(bitmap->data);
+    }
+    heap_free(bitmap);
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+    return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+    return bitmap->stride;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+    return bitmap->format;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+    return bitmap->bounds;
+}
+
+// 1 bit pixels are white when every channel is at least half, like the SDK's fallback
+static bool color_white(GColor color) {
+    return ((color.argb & 0x30) >= 0x20) && ((color.argb & 0x0C) >= 0x08) && ((color.argb & 0x03) >= 0x02);
+}
+
+static uint8_t bitmap_get(const GBitmap *bitmap, int16_t x, int16_t y) {
+    if (bitmap->format == GBitmapFormat8Bit) {
+        return bitmap->data[y * bitmap->stride + x];
+    }
+    return (bitmap->data[y * bitmap->stride + x / 8] >> (x % 8)) & 1;
+}
+
+static void bitmap_set(GBitmap *bitmap, int16_t x, int16_t y, GColor color) {
+    if (bitmap->format == GBitmapFormat8Bit) {
+        bitmap->data[y * bitmap->stride + x] = color.argb;
+        return;
+    }
+    uint8_t *byte = &bitmap->data[y * bitmap->stride + x / 8];
+    *byte = color_white(color) ? (*byte | (1 << (x % 8))) : (*byte & ~(1 << (x % 8)));
+}
+
+
+//======================================
+// GRAPHICS CONTEXT
+//======================================
+struct GContext {
+    GBitmap *fb;
+    bool captured;
+    GPoint offset;      // screen position of the drawing layer's bounds
+    GRect clip;         // screen pixels the layer may touch
+    GColor fill, stroke, text;
+    uint8_t stroke_width;
+    bool antialiased;
+    GCompOp compositing;
+};
+
+static GBitmap s_screen;
+static uint8_t s_screen_data[HOST_SCREEN_H * HOST_SCREEN_W];
+static GContext s_ctx;
+
+static void screen_init(void) {
+    if (s_screen.data) {
+        return;
+    }
+    s_screen.data = s_screen_data;
+    s_screen.format = HOST_SCREEN_FORMAT;
+    s_screen.bounds = GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H);
+    s_screen.stride = bitmap_stride(s_screen.bounds.size, s_screen.format);
+    s_ctx.fb = &s_screen;
+}
+
+static void context_reset(GContext *ctx, GPoint offset, GRect clip) {
+    ctx->offset = offset;
+    ctx->clip = clip;
+    ctx->fill = GColorBlack;
+    ctx->stroke = GColorBlack;
+    ctx->text = GColorWhite;
+    ctx->stroke_width = 1;
+    ctx->antialiased = true;
+    ctx->compositing = GCompOpAssign;
+}
+
+// x, y in the drawing layer's coordinates, clear colors draw nothing
+static void context_pixel(GContext *ctx, int16_t x, int16_t y, GColor color) {
+    x += ctx->offset.x;
+    y += ctx->offset.y;
+    if ((color.argb & 0xC0) == 0) {
+        return;
+    }
+    if ((x < ctx->clip.origin.x) || (x >= ctx->clip.origin.x + ctx->clip.size.w) ||
+        (y < ctx->clip.origin.y) || (y >= ctx->clip.origin.y + ctx->clip.size.h)) {
+        return;
+    }
+    bitmap_set(ctx->fb, x, y, color);
+}
+
+static void context_span(GContext *ctx, int16_t y, int16_t x0, int16_t x1, GColor color) {
+    for (int16_t x = x0; x <= x1; ++x) {
+        context_pixel(ctx, x, y, color);
+    }
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) { ctx->fill = color; }
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) { ctx->stroke = color; }
+void graphics_context_set_text_color(GContext *ctx, GColor color) { ctx->text = color; }
+void graphics_context_set_antialiased(GContext *ctx, bool enable) { ctx->antialiased = enable; }
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) { ctx->compositing = mode; }
+
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t width) {
+    ctx->stroke_width = (width == 0) ? 1 : width;
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+    if (ctx->captured) {
+        return NULL;
+    }
+    ctx->captured = true;
+    return ctx->fb;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+    if (!ctx->captured || (buffer != ctx->fb)) {
+        return false;
+    }
+    ctx->captured = false;
+    return true;
+}
+
+
+//======================================
+// SHAPES
+//======================================
+// pixel centers inside a rect with its corners rounded by radius
+static bool rounded_contains(GRect rect, uint16_t radius, GCornerMask corners, int16_t x, int16_t y) {
+    int16_t right = rect.origin.x + rect.size.w - 1, bottom = rect.origin.y + rect.size.h - 1;
+    if ((x < rect.origin.x) || (x > right) || (y < rect.origin.y) || (y > bottom)) {
+        return false;
+    }
+    int16_t r = radius;
+    r = (r > rect.size.w / 2) ? rect.size.w / 2 : r;
+    r = (r > rect.size.h / 2) ? rect.size.h / 2 : r;
+    if (r <= 0) {
+        return true;
+    }
+    bool left_side = x < rect.origin.x + r, right_side = x > right - r;
+    bool top_side = y < rect.origin.y + r, bottom_side = y > bottom - r;
+    GCornerMask corner = top_side ? (left_side ? 1 : (right_side ? 2 : 0)) : (bottom_side ? (left_side ? 4 : (right_side ? 8 : 0)) : 0);
+    if (!(corners & corner)) {
+        return true;
+    }
+    // distance in half pixels from the corner circle's center
+    int32_t cx = left_side ? 2 * (rect.origin.x + r) : 2 * (right - r + 1);
+    int32_t cy = top_side ? 2 * (rect.origin.y + r) : 2 * (bottom - r + 1);
+    int32_t dx = 2 * x + 1 - cx, dy = 2 * y + 1 - cy;
+    return dx * dx + dy * dy <= 4 * r * r;
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corners) {
+    for (int16_t y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+        for (int16_t x = rect.origin.x; x < rect.origin.x + rect.size.w; ++x) {
+            if (rounded_contains(rect, corner_radius, corners, x, y)) {
+                context_pixel(ctx, x, y, ctx->fill);
+            }
+        }
+    }
+}
+
+void graphics_draw_round_rect(GContext *ctx, GRect rect, uint16_t radius) {
+    int16_t width = ctx->stroke_width;
+    GRect inner = GRect(rect.origin.x + width, rect.origin.y + width, rect.size.w - 2 * width, rect.size.h - 2 * width);
+    uint16_t inner_radius = (radius > width) ? radius - width : 0;
+    for (int16_t y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+        for (int16_t x = rect.origin.x; x < rect.origin.x + rect.size.w; ++x) {
+            if (rounded_contains(rect, radius, GCornersAll, x, y) &&
+                ((inner.size.w <= 0) || (inner.size.h <= 0) || !rounded_contains(inner, inner_radius, GCornersAll, x, y))) {
+                context_pixel(ctx, x, y, ctx->stroke);
+            }
+        }
+    }
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+    uint8_t width = ctx->stroke_width;
+    ctx->stroke_width = 1;
+    graphics_draw_round_rect(ctx, rect, 0);
+    ctx->stroke_width = width;
+}
+
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+    context_pixel(ctx, point.x, point.y, ctx->stroke);
+}
+
+// Bresenham, wider strokes stamp a square of the stroke width on every step
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+    int16_t dx = abs(p1.x - p0.x), dy = -abs(p1.y - p0.y);
+    int16_t sx = (p0.x < p1.x) ? 1 : -1, sy = (p0.y < p1.y) ? 1 : -1;
+    int16_t error = dx + dy;
+    int16_t before = (ctx->stroke_width - 1) / 2, after = ctx->stroke_width / 2;
+    for (;;) {
+        for (int16_t y = p0.y - before; y <= p0.y + after; ++y) {
+            context_span(ctx, y, p0.x - before, p0.x + after, ctx->stroke);
+        }
+        if ((p0.x == p1.x) && (p0.y == p1.y)) {
+            break;
+        }
+        int16_t twice = 2 * error;
+        if (twice >= dy) {
+            error += dy;
+            p0.x += sx;
+        }
+        if (twice <= dx) {
+            error += dx;
+            p0.y += sy;
+        }
+    }
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint center, uint16_t radius) {
+    int32_t limit = radius * radius + radius;
+    for (int16_t dy = -radius; dy <= radius; ++dy) {
+        for (int16_t dx = -radius; dx <= radius; ++dx) {
+            if (dx * dx + dy * dy <= limit) {
+                context_pixel(ctx, center.x + dx, center.y + dy, ctx->fill);
+            }
+        }
+    }
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint center, uint16_t radius) {
+    int32_t outer = radius * radius + radius;
+    int32_t inner_radius = (int32_t)radius - ctx->stroke_width;
+    int32_t inner = (inner_radius >= 0) ? inner_radius * inner_radius + inner_radius : -1;
+    for (int16_t dy = -radius; dy <= radius; ++dy) {
+        for (int16_t dx = -radius; dx <= radius; ++dx) {
+            int32_t distance = dx * dx + dy * dy;
+            if ((distance <= outer) && (distance > inner)) {
+                context_pixel(ctx, center.x + dx, center.y + dy, ctx->stroke);
+            }
+        }
+    }
+}
+
+// GCompOpSet leaves the source's clear (or 0 bit) pixels out, the other modes copy
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+    GRect source = bitmap->bounds;
+    for (int16_t y = 0; (y < rect.size.h) && (y < source.size.h); ++y) {
+        for (int16_t x = 0; (x < rect.size.w) && (x < source.size.w); ++x) {
+            uint8_t value = bitmap_get(bitmap, source.origin.x + x, source.origin.y + y);
+            GColor color = { .argb = value };
+            if (bitmap->format != GBitmapFormat8Bit) {
+                color = value ? GColorWhite : ((ctx->compositing == GCompOpSet) ? GColorClear : GColorBlack);
+            }
+            else if ((ctx->compositing != GCompOpSet) && ((value & 0xC0) == 0)) {
+                color = GColorBlack;
+            }
+            context_pixel(ctx, rect.origin.x + x, rect.origin.y + y, color);
+        }
+    }
+}
+
+
+//======================================
+// PATHS
+//======================================
+GPath *gpath_create(const GPathInfo *init) {
+    GPath *path = heap_alloc(sizeof(GPath));
+    if (!path) {
+        return NULL;
+    }
+    path->num_points = init->num_points;
+    path->points = init->points;
+    return path;
+}
+
+void gpath_destroy(GPath *path) {
+    heap_free(path);
+}
+
+void gpath_rotate_to(GPath *path, int32_t angle) {
+    path->rotation = angle;
+}
+
+void gpath_move_to(GPath *path, GPoint point) {
+    path->offset = point;
+}
+
+static GPoint gpath_point(const GPath *path, uint32_t i) {
+    GPoint point = path->points[i % path->num_points];
+    if (path->rotation != 0) {
+        int32_t s = sin_lookup(path->rotation), c = cos_lookup(path->rotation);
+        point = GPoint((point.x * c - point.y * s) / TRIG_MAX_RATIO, (point.x * s + point.y * c) / TRIG_MAX_RATIO);
+    }
+    return GPoint(point.x + path->offset.x, point.y + path->offset.y);
+}
+
+// even-odd fill, rows sampled through pixel centers
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+    if (path->num_points < 3) {
+        return;
+    }
+    int16_t top = INT16_MAX, bottom = INT16_MIN;
+    for (uint32_t i = 0; i < path->num_points; ++i) {
+        GPoint point = gpath_point(path, i);
+        top = (point.y < top) ? point.y : top;
+        bottom = (point.y > bottom) ? point.y : bottom;
+    }
+
+    double crossings[32];
+    for (int16_t y = top; y <= bottom; ++y) {
+        double sample = y + 0.5;
+        int count = 0;
+        for (uint32_t i = 0; (i < path->num_points) && (count < 32); ++i) {
+            GPoint a = gpath_point(path, i), b = gpath_point(path, i + 1);
+            if ((a.y == b.y) || ((sample < a.y) == (sample < b.y))) {
+                continue;
+            }
+            crossings[count++] = a.x + (sample - a.y) * (b.x - a.x) / (b.y - a.y);
+        }
+        for (int i = 1; i < count; ++i) {
+            for (int j = i; (j > 0) && (crossings[j - 1] > crossings[j]); --j) {
+                double swap = crossings[j];
+                crossings[j] = crossings[j - 1];
+                crossings[j - 1] = swap;
+            }
+        }
+        for (int i = 0; i + 1 < count; i += 2) {
+            context_span(ctx, y, (int16_t)ceil(crossings[i] - 0.5), (int16_t)floor(crossings[i + 1] - 0.5), ctx->fill);
+        }
+    }
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+    for (uint32_t i = 0; i < path->num_points; ++i) {
+        graphics_draw_line(ctx, gpath_point(path, i), gpath_point(path, i + 1));
+    }
+}
+
+
+//======================================
+// FONTS AND TEXT
+//======================================
+struct FontInfo {
+    int16_t height;   // line height
+    int16_t advance;  // width of every character
+    bool custom;
+};
+
+static struct FontInfo s_system_fonts[] = {
+    { 14, 6, false },   // FONT_KEY_GOTHIC_14
+    { 18, 8, false },   // FONT_KEY_GOTHIC_18_BOLD
+    { 34, 16, false }   // FONT_KEY_BITHAM_34_MEDIUM_NUMBERS
+};
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+    return (ResHandle)(uintptr_t)resource_id;
+}
+
+size_t resource_size(ResHandle handle) {
+    return 0;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+    if (strcmp(font_key, FONT_KEY_GOTHIC_18_BOLD) == 0) {
+        return &s_system_fonts[1];
+    }
+    if (strcmp(font_key, FONT_KEY_BITHAM_34_MEDIUM_NUMBERS) == 0) {
+        return &s_system_fonts[2];
+    }
+    return &s_system_fonts[0];
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+    GFont font = heap_alloc(sizeof(struct FontInfo));
+    if (font) {
+        *font = (struct FontInfo){ 34, 16, true }; // RESOURCE_ID_FONT_ROUNDY_34_BOLD
+    }
+    return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+    if (font && font->custom) {
+        heap_free(font);
+    }
+}
+
+// characters, not bytes, UTF-8 continuation bytes take no space
+static int16_t text_chars(const char *text, size_t length) {
+    int16_t chars = 0;
+    for (size_t i = 0; i < length; ++i) {
+        chars += ((text[i] & 0xC0) != 0x80);
+    }
+    return chars;
+}
+
+static void text_line_draw(GContext *ctx, const char *line, size_t length, GFont font, GRect box, int16_t y,
+                           GTextAlignment alignment) {
+    int16_t width = text_chars(line, length) * font->advance;
+    int16_t x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) {
+        x += (box.size.w - width) / 2;
+    }
+    else if (alignment == GTextAlignmentRight) {
+        x += box.size.w - width;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if ((line[i] & 0xC0) == 0x80) {
+            continue;
+        }
+        if (line[i] != ' ') {
+            GRect glyph = GRect(x + 1, y + font->height / 4, font->advance - 2, font->height / 2);
+            for (int16_t gy = glyph.origin.y; gy < glyph.origin.y + glyph.size.h; ++gy) {
+                context_span(ctx, gy, glyph.origin.x, glyph.origin.x + glyph.size.w - 1, ctx->text);
+            }
+        }
+        x += font->advance;
+    }
+}
+
+// lines break at newlines and wrap at spaces, lines past the box are left out
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow, GTextAlignment alignment, void *attributes) {
+    if (!text || !font) {
+        return;
+    }
+    int16_t max_chars = box.size.w / font->advance;
+    int16_t y = box.origin.y;
+    const char *line = text;
+    while (*line) {
+        size_t length = strcspn(line, "\n");
+        size_t fits = length;
+        if ((overflow == GTextOverflowModeWordWrap) && (text_chars(line, length) > max_chars)) {
+            fits = 0;
+            for (size_t i = 0; i < length; ++i) {
+                if ((line[i] == ' ') && (text_chars(line, i) <= max_chars)) {
+                    fits = i;
+                }
+            }
+            fits = (fits == 0) ? length : fits;
+        }
+        if ((y != box.origin.y) && (y + font->height > box.origin.y + box.size.h)) {
+            return;
+        }
+        text_line_draw(ctx, line, fits, font, box, y, alignment);
+        y += font->height;
+        line += fits;
+        if ((*line == '\n') || (*line == ' ')) {
+            line++;
+        }
+    }
+}
+
+
+//======================================
+// LAYERS
+//======================================
+typedef enum { LAYER_PLAIN, LAYER_TEXT, LAYER_BITMAP } LayerKind;
+
+struct Layer {
+    GRect frame;
+    GRect bounds;
+    LayerUpdateProc update_proc;
+    Layer *parent, *first_child, *next_sibling;
+    bool hidden;
+    LayerKind kind;
+    void *data;
+};
+
+struct TextLayer {
+    Layer layer;
+    const char *text;
+    GFont font;
+    GColor text_color, background_color;
+    GTextAlignment alignment;
+};
+
+struct BitmapLayer {
+    Layer layer;
+    const GBitmap *bitmap;
+    GCompOp compositing;
+};
+
+struct Window {
+    Layer root;
+    WindowHandlers handlers;
+    GColor background;
+    bool loaded;
+};
+
+static bool s_dirty = false;    // something was marked, the next render draws the window
+static Window *s_top_window = NULL;
+static uint32_t s_frames = 0;
+static bool s_overlay = false;  // a system window covers the app
+
+static void layer_init(Layer *layer, GRect frame, LayerKind kind) {
+    layer->frame = frame;
+    layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+    layer->kind = kind;
+}
+
+Layer *layer_create(GRect frame) {
+    Layer *layer = heap_alloc(sizeof(Layer));
+    if (layer) {
+        layer_init(layer, frame, LAYER_PLAIN);
+    }
+    return layer;
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+    Layer *layer = layer_create(frame);
+    if (layer) {
+        layer->data = heap_alloc(data_size);
+    }
+    return layer;
+}
+
+void *layer_get_data(const Layer *layer) {
+    return layer->data;
+}
+
+void layer_remove_from_parent(Layer *child) {
+    if (!child->parent) {
+        return;
+    }
+    Layer **link = &child->parent->first_child;
+    while (*link && (*link != child)) {
+        link = &(*link)->next_sibling;
+    }
+    if (*link) {
+        *link = child->next_sibling;
+    }
+    child->parent = NULL;
+    child->next_sibling = NULL;
+    s_dirty = true;
+}
+
+void layer_destroy(Layer *layer) {
+    if (!layer) {
+        return;
+    }
+    layer_remove_from_parent(layer);
+    heap_free(layer->data);
+    heap_free(layer);
+}
+
+void layer_mark_dirty(Layer *layer) {
+    s_dirty = true;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+    layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+    layer_remove_from_parent(child);
+    Layer **link = &parent->first_child;
+    while (*link) {
+        link = &(*link)->next_sibling;
+    }
+    *link = child;
+    child->parent = parent;
+    s_dirty = true;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+    return layer->frame;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+    return layer->bounds;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+    layer->hidden = hidden;
+    s_dirty = true;
+}
+
+static void text_layer_update_proc(Layer *layer, GContext *ctx) {
+    TextLayer *text_layer = (TextLayer *)layer;
+    graphics_context_set_fill_color(ctx, text_layer->background_color);
+    graphics_fill_rect(ctx, layer->bounds, 0, GCornerNone);
+    graphics_context_set_text_color(ctx, text_layer->text_color);
+    graphics_draw_text(ctx, text_layer->text, text_layer->font, layer->bounds, GTextOverflowModeWordWrap,
+                       text_layer->alignment, NULL);
+}
+
+TextLayer *text_layer_create(GRect frame) {
+    TextLayer *text_layer = heap_alloc(sizeof(TextLayer));
+    if (!text_layer) {
+        return NULL;
+    }
+    layer_init(&text_layer->layer, frame, LAYER_TEXT);
+    text_layer->layer.update_proc = text_layer_update_proc;
+    text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+    text_layer->text_color = GColorBlack;
+    text_layer->background_color = GColorWhite;
+    return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) { layer_destroy(&text_layer->layer); }
+Layer *text_layer_get_layer(TextLayer *text_layer) { return &text_layer->layer; }
+void text_layer_set_text(TextLayer *text_layer, const char *text) { text_layer->text = text; s_dirty = true; }
+void text_layer_set_font(TextLayer *text_layer, GFont font) { text_layer->font = font; s_dirty = true; }
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) { text_layer->text_color = color; s_dirty = true; }
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) { text_layer->background_color = color; s_dirty = true; }
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment) { text_layer->alignment = alignment; s_dirty = true; }
+
+static void bitmap_layer_update_proc(Layer *layer, GContext *ctx) {
+    BitmapLayer *bitmap_layer = (BitmapLayer *)layer;
+    if (bitmap_layer->bitmap) {
+        graphics_context_set_compositing_mode(ctx, bitmap_layer->compositing);
+        graphics_draw_bitmap_in_rect(ctx, bitmap_layer->bitmap, layer->bounds);
+    }
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame) {
+    BitmapLayer *bitmap_layer = heap_alloc(sizeof(BitmapLayer));
+    if (!bitmap_layer) {
+        return NULL;
+    }
+    layer_init(&bitmap_layer->layer, frame, LAYER_BITMAP);
+    bitmap_layer->layer.update_proc = bitmap_layer_update_proc;
+    bitmap_layer->compositing = GCompOpAssign;
+    return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer) { layer_destroy(&bitmap_layer->layer); }
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer) { return (Layer *)&bitmap_layer->layer; }
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap) { bitmap_layer->bitmap = bitmap; s_dirty = true; }
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode) { bitmap_layer->compositing = mode; s_dirty = true; }
+
+
+//======================================
+// WINDOWS
+//======================================
+Window *window_create(void) {
+    Window *window = heap_alloc(sizeof(Window));
+    if (!window) {
+        return NULL;
+    }
+    screen_init();
+    layer_init(&window->root, GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H), LAYER_PLAIN);
+    window->background = GColorWhite;
+    return window;
+}
+
+void window_destroy(Window *window) {
+    if (!window) {
+        return;
+    }
+    if (window->loaded) {
+        if (window->handlers.disappear) {
+            window->handlers.disappear(window);
+        }
+        if (window->handlers.unload) {
+            window->handlers.unload(window);
+        }
+    }
+    if (s_top_window == window) {
+        s_top_window = NULL;
+    }
+    heap_free(window);
+}
+
+Layer *window_get_root_layer(const Window *window) {
+    return (Layer *)&window->root;
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+    window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor color) {
+    window->background = color;
+}
+
+void window_stack_push(Window *window, bool animated) {
+    s_top_window = window;
+    if (!window->loaded && window->handlers.load) {
+        window->handlers.load(window);
+    }
+    window->loaded = true;
+    if (window->handlers.appear) {
+        window->handlers.appear(window);
+    }
+    s_dirty = true;
+}
+
+// children draw over their parent, clipped to every frame above them
+static void layer_render(Layer *layer, GPoint origin, GRect clip) {
+    if (layer->hidden) {
+        return;
+    }
+    GPoint offset = GPoint(origin.x + layer->frame.origin.x + layer->bounds.origin.x,
+                           origin.y + layer->frame.origin.y + layer->bounds.origin.y);
+    GRect frame = GRect(origin.x + layer->frame.origin.x, origin.y + layer->frame.origin.y,
+                        layer->frame.size.w, layer->frame.size.h);
+    grect_clip(&clip, &frame);
+    if (layer->update_proc) {
+        context_reset(&s_ctx, offset, clip);
+        layer->update_proc(layer, &s_ctx);
+        if (s_ctx.captured) {
+            fprintf(stderr, "host: frame buffer still captured after an update proc\n");
+            abort();
+        }
+    }
+    for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+        layer_render(child, offset, clip);
+    }
+}
+
+bool host_render(void) {
+    if (!s_dirty || !s_top_window || s_overlay) {
+        return false;
+    }
+    s_dirty = false;
+    GRect screen = GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H);
+    context_reset(&s_ctx, GPointZero, screen);
+    graphics_context_set_fill_color(&s_ctx, s_top_window->background);
+    graphics_fill_rect(&s_ctx, screen, 0, GCornerNone);
+    layer_render(&s_top_window->root, GPointZero, screen);
+    s_frames++;
+    return true;
+}
+
+uint32_t host_frames(void) {
+    return s_frames;
+}
+
+
+//======================================
+// FRAME BUFFER ACCESS
+//======================================
+GBitmap *host_frame_buffer(void) {
+    screen_init();
+    return &s_screen;
+}
+
+GColor host_pixel(const GBitmap *bitmap, int16_t x, int16_t y) {
+    uint8_t value = bitmap_get(bitmap, bitmap->bounds.origin.x + x, bitmap->bounds.origin.y + y);
+    if (bitmap->format == GBitmapFormat8Bit) {
+        return (GColor){ .argb = value };
+    }
+    return value ? GColorWhite : GColorBlack;
+}
+
+GBitmap *host_bitmap_copy(const GBitmap *bitmap) {
+    GBitmap *copy = gbitmap_create_blank(bitmap->bounds.size, bitmap->format);
+    if (!copy) {
+        return NULL;
+    }
+    for (int16_t y = 0; y < bitmap->bounds.size.h; ++y) {
+        for (int16_t x = 0; x < bitmap->bounds.size.w; ++x) {
+            bitmap_set(copy, x, y, host_pixel(bitmap, x, y));
+        }
+    }
+    return copy;
+}
+
+uint32_t host_bitmap_diff(const GBitmap *a, const GBitmap *b, GPoint *first) {
+    uint32_t pixels = 0;
+    for (int16_t y = 0; y < a->bounds.size.h; ++y) {
+        for (int16_t x = 0; x < a->bounds.size.w; ++x) {
+            if (host_pixel(a, x, y).argb == host_pixel(b, x, y).argb) {
+                continue;
+            }
+            if ((pixels++ == 0) && first) {
+                *first = GPoint(x, y);
+            }
+        }
+    }
+    return pixels;
+}
+
+void host_frame_buffer_scribble(void) {
+    screen_init();
+    for (int16_t y = 0; y < HOST_SCREEN_H; ++y) {
+        for (int16_t x = 0; x < HOST_SCREEN_W; ++x) {
+            // 0xE5 is a pink none of the themes use
+            bitmap_set(&s_screen, x, y, ((x + y) % 3) ? (GColor){ .argb = 0xE5 } : GColorWhite);
+        }
+    }
+}
+
+void host_bitmap_ascii(FILE *out, const GBitmap *bitmap, GRect rect, const char *palette) {
+    size_t colors = strlen(palette);
+    for (int16_t y = rect.origin.y; y < rect.origin.y + rect.size.h; ++y) {
+        for (int16_t x = rect.origin.x; x < rect.origin.x + rect.size.w; ++x) {
+            uint8_t value = bitmap_get(bitmap, bitmap->bounds.origin.x + x, bitmap->bounds.origin.y + y);
+            fputc((value < colors) ? palette[value] : '?', out);
+        }
+        fputc('\n', out);
+    }
+}
+
+bool host_bitmap_write_ppm(const char *path, const GBitmap *bitmap) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", bitmap->bounds.size.w, bitmap->bounds.size.h);
+    for (int16_t y = 0; y < bitmap->bounds.size.h; ++y) {
+        for (int16_t x = 0; x < bitmap->bounds.size.w; ++x) {
+            uint8_t argb = host_pixel(bitmap, x, y).argb;
+            uint8_t rgb[3] = { ((argb >> 4) & 3) * 85, ((argb >> 2) & 3) * 85, (argb & 3) * 85 };
+            fwrite(rgb, 1, sizeof(rgb), file);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+
+//======================================
+// CLOCK AND TIMERS
+//======================================
+// the clock only moves when a test moves it, in milliseconds since the epoch
+// 2016-03-07 09:41:00 UTC, a Monday
+static int64_t s_now_ms = 1457343660LL * 1000;
+static bool s_clock24 = true;
+
+struct AppTimer {
+    int64_t due_ms;
+    AppTimerCallback callback;
+    void *data;
+    bool active;
+};
+static AppTimer s_timers[HOST_TIMERS];
+
+// localtime and friends run in UTC so the tests don't depend on the machine
+__attribute__((constructor)) static void clock_init(void) {
+    setenv("TZ", "UTC", 1);
+    tzset();
+}
+
+time_t shim_time(time_t *tloc) {
+    time_t now = (time_t)(s_now_ms / 1000);
+    if (tloc) {
+        *tloc = now;
+    }
+    return now;
+}
+
+// the clock's milliseconds plus the real time spent since it was last moved,
+// so differences of time_ms measure the code in between like on the watch
+static struct timespec s_moved_at;
+
+static int64_t real_ms_since_moved(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - s_moved_at.tv_sec) * 1000 + (now.tv_nsec - s_moved_at.tv_nsec) / 1000000;
+}
+
+static void clock_move(int64_t now_ms) {
+    s_now_ms = now_ms;
+    clock_gettime(CLOCK_MONOTONIC, &s_moved_at);
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+    if (s_moved_at.tv_sec == 0) {
+        clock_move(s_now_ms);
+    }
+    int64_t now = s_now_ms + real_ms_since_moved();
+    uint16_t ms = now % 1000;
+    if (tloc) {
+        *tloc = (time_t)(now / 1000);
+    }
+    if (out_ms) {
+        *out_ms = ms;
+    }
+    return ms;
+}
+
+time_t time_start_of_today(void) {
+    time_t now = shim_time(NULL);
+    struct tm today = *localtime(&now);
+    today.tm_hour = 0;
+    today.tm_min = 0;
+    today.tm_sec = 0;
+    return mktime(&today);
+}
+
+bool clock_is_24h_style(void) {
+    return s_clock24;
+}
+
+void host_clock_24h_set(bool clock24) {
+    s_clock24 = clock24;
+}
+
+void host_time_set(time_t now) {
+    clock_move((int64_t)now * 1000);
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+    for (int i = 0; i < HOST_TIMERS; ++i) {
+        if (!s_timers[i].active) {
+            s_timers[i] = (AppTimer){ s_now_ms + timeout_ms, callback, callback_data, true };
+            return &s_timers[i];
+        }
+    }
+    return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+    if (!timer || !timer->active) {
+        return false;
+    }
+    timer->due_ms = s_now_ms + new_timeout_ms;
+    return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+    if (timer) {
+        timer->active = false;
+    }
+}
+
+// earliest active timer due by limit_ms
+static AppTimer *timers_next(int64_t limit_ms) {
+    AppTimer *next = NULL;
+    for (int i = 0; i < HOST_TIMERS; ++i) {
+        if (s_timers[i].active && (s_timers[i].due_ms <= limit_ms) && (!next || (s_timers[i].due_ms < next->due_ms))) {
+            next = &s_timers[i];
+        }
+    }
+    return next;
+}
+
+static void timer_fire(AppTimer *timer) {
+    timer->active = false;
+    if (timer->due_ms > s_now_ms) {
+        clock_move(timer->due_ms);
+    }
+    timer->callback(timer->data);
+    host_render();
+}
+
+void host_timers_run(void) {
+    AppTimer *timer;
+    while ((timer = timers_next(s_now_ms))) {
+        timer_fire(timer);
+    }
+}
+
+
+//======================================
+// TICKS
+//======================================
+static TickHandler s_tick_handler = NULL;
+static TimeUnits s_tick_units = 0;
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+    s_tick_units = tick_units;
+    s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+    s_tick_handler = NULL;
+}
+
+// the units that changed from before to after, each unit also changes the smaller ones
+static TimeUnits units_changed(const struct tm *before, const struct tm *after) {
+    TimeUnits units = 0;
+    units |= (before->tm_year != after->tm_year) ? YEAR_UNIT : 0;
+    units |= (units || (before->tm_mon != after->tm_mon)) ? MONTH_UNIT : 0;
+    units |= (units || (before->tm_mday != after->tm_mday)) ? DAY_UNIT : 0;
+    units |= (units || (before->tm_hour != after->tm_hour)) ? HOUR_UNIT : 0;
+    units |= (units || (before->tm_min != after->tm_min)) ? MINUTE_UNIT : 0;
+    units |= (units || (before->tm_sec != after->tm_sec)) ? SECOND_UNIT : 0;
+    return units;
+}
+
+void host_advance(uint32_t seconds) {
+    while (seconds-- > 0) {
+        time_t before_seconds = shim_time(NULL);
+        struct tm before = *localtime(&before_seconds);
+        int64_t next_second = (s_now_ms / 1000 + 1) * 1000;
+        AppTimer *timer;
+        while ((timer = timers_next(next_second))) {
+            timer_fire(timer);
+        }
+        clock_move(next_second);
+
+        time_t after_seconds = shim_time(NULL);
+        struct tm after = *localtime(&after_seconds);
+        TimeUnits units = units_changed(&before, &after);
+        // only the subscribed unit and the ones above it, like the tick service
+        TimeUnits smallest = s_tick_units & -s_tick_units;
+        units &= ~(smallest - 1);
+        if (s_tick_handler && units) {
+            s_tick_handler(&after, units);
+        }
+        host_render();
+    }
+}
+
+
+//======================================
+// SERVICES
+//======================================
+static BatteryStateHandler s_battery_handler = NULL;
+static BatteryChargeState s_battery = { .charge_percent = 80, .is_charging = false, .is_plugged = false };
+static BluetoothConnectionHandler s_bluetooth_handler = NULL;
+static bool s_bluetooth = true;
+static AccelTapHandler s_tap_handler = NULL;
+static AppFocusHandlers s_focus_handlers;
+static uint32_t s_vibes = 0;
+
+void battery_state_service_subscribe(BatteryStateHandler handler) { s_battery_handler = handler; }
+void battery_state_service_unsubscribe(void) { s_battery_handler = NULL; }
+BatteryChargeState battery_state_service_peek(void) { return s_battery; }
+
+void host_battery_set(BatteryChargeState state) {
+    s_battery = state;
+    if (s_battery_handler) {
+        s_battery_handler(state);
+    }
+    host_render();
+}
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler) { s_bluetooth_handler = handler; }
+void bluetooth_connection_service_unsubscribe(void) { s_bluetooth_handler = NULL; }
+bool bluetooth_connection_service_peek(void) { return s_bluetooth; }
+
+void host_bluetooth_set(bool connected) {
+    s_bluetooth = connected;
+    if (s_bluetooth_handler) {
+        s_bluetooth_handler(connected);
+    }
+    host_render();
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) { s_tap_handler = handler; }
+void accel_tap_service_unsubscribe(void) { s_tap_handler = NULL; }
+
+void host_tap(void) {
+    if (s_tap_handler) {
+        s_tap_handler(ACCEL_AXIS_Z, 1);
+    }
+    host_render();
+}
+
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers) { s_focus_handlers = handlers; }
+void app_focus_service_subscribe(AppFocusHandler handler) { s_focus_handlers = (AppFocusHandlers){ .did_focus = handler }; }
+void app_focus_service_unsubscribe(void) { s_focus_handlers = (AppFocusHandlers){ 0 }; }
+
+// the overlay's pixels stay in the frame buffer until the app draws over them
+void host_overlay_show(void) {
+    if (s_focus_handlers.will_focus) {
+        s_focus_handlers.will_focus(false);
+    }
+    s_overlay = true;
+    host_frame_buffer_scribble();
+    if (s_focus_handlers.did_focus) {
+        s_focus_handlers.did_focus(false);
+    }
+}
+
+// the system draws the window again as the overlay goes, then focus comes back
+void host_overlay_hide(void) {
+    if (s_focus_handlers.will_focus) {
+        s_focus_handlers.will_focus(true);
+    }
+    s_overlay = false;
+    s_dirty = true;
+    host_render();
+    if (s_focus_handlers.did_focus) {
+        s_focus_handlers.did_focus(true);
+    }
+    host_render();
+}
+
+void vibes_short_pulse(void) { s_vibes++; }
+void vibes_long_pulse(void) { s_vibes++; }
+void vibes_double_pulse(void) { s_vibes++; }
+uint32_t host_vibes(void) { return s_vibes; }
+
+
+//======================================
+// HEALTH
+//======================================
+static HealthEventHandler s_health_handler = NULL;
+static void *s_health_context = NULL;
+static HealthValue s_health_values[HealthMetricCount];
+static uint32_t s_health_queries = 0;
+
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t time_start, time_t time_end) {
+    return HealthServiceAccessibilityMaskAvailable;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+    s_health_queries++;
+    return (metric < HealthMetricCount) ? s_health_values[metric] : 0;
+}
+
+// like the watch, subscribing delivers today's totals right away
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+    s_health_handler = handler;
+    s_health_context = context;
+    handler(HealthEventSignificantUpdate, context);
+    return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+    s_health_handler = NULL;
+    return true;
+}
+
+void host_health_set(HealthMetric metric, HealthValue value) {
+    s_health_values[metric] = value;
+}
+
+void host_health_event(HealthEventType event) {
+    if (s_health_handler) {
+        s_health_handler(event, s_health_context);
+    }
+    host_render();
+}
+
+uint32_t host_health_queries(void) {
+    return s_health_queries;
+}
+
+
+//======================================
+// PERSIST
+//======================================
+typedef struct PersistEntry {
+    bool used;
+    uint32_t key;
+    uint16_t size;
+    uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+static PersistEntry s_persist[HOST_PERSIST_KEYS];
+
+static PersistEntry *persist_find(uint32_t key) {
+    for (int i = 0; i < HOST_PERSIST_KEYS; ++i) {
+        if (s_persist[i].used && (s_persist[i].key == key)) {
+            return &s_persist[i];
+        }
+    }
+    return NULL;
+}
+
+bool persist_exists(uint32_t key) {
+    return persist_find(key) != NULL;
+}
+
+int persist_get_size(uint32_t key) {
+    PersistEntry *entry = persist_find(key);
+    return entry ? entry->size : E_DOES_NOT_EXIST;
+}
+
+static int s_persist_short_read = -1;
+
+void host_persist_short_read(int bytes) {
+    s_persist_short_read = bytes;
+}
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size) {
+    PersistEntry *entry = persist_find(key);
+    if (!entry) {
+        return E_DOES_NOT_EXIST;
+    }
+    size_t size = (entry->size < buffer_size) ? entry->size : buffer_size;
+    if ((s_persist_short_read >= 0) && (size > (size_t)s_persist_short_read)) {
+        size = s_persist_short_read;
+    }
+    s_persist_short_read = -1;
+    memcpy(buffer, entry->data, size);
+    return size;
+}
+
+int persist_write_data(uint32_t key, const void *data, size_t size) {
+    PersistEntry *entry = persist_find(key);
+    for (int i = 0; !entry && (i < HOST_PERSIST_KEYS); ++i) {
+        if (!s_persist[i].used) {
+            entry = &s_persist[i];
+        }
+    }
+    if (!entry) {
+        return -1;
+    }
+    size = (size < PERSIST_DATA_MAX_LENGTH) ? size : PERSIST_DATA_MAX_LENGTH;
+    *entry = (PersistEntry){ .used = true, .key = key, .size = size };
+    memcpy(entry->data, data, size);
+    return size;
+}
+
+status_t persist_delete(uint32_t key) {
+    PersistEntry *entry = persist_find(key);
+    if (!entry) {
+        return E_DOES_NOT_EXIST;
+    }
+    entry->used = false;
+    return S_SUCCESS;
+}
+
+
+//======================================
+// MESSAGES
+//======================================
+struct DictionaryIterator {
+    uint32_t tuples;
+};
+static DictionaryIterator s_outbox;
+static bool s_outbox_open = false;
+static uint32_t s_messages_sent = 0;
+static AppSync *s_sync = NULL;
+
+AppMessageResult app_message_open(uint32_t size_inbound, uint32_t size_outbound) {
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+    if (s_outbox_open) {
+        *iterator = NULL;
+        return APP_MSG_BUSY;
+    }
+    s_outbox = (DictionaryIterator){ 0 };
+    s_outbox_open = true;
+    *iterator = &s_outbox;
+    return APP_MSG_OK;
+}
+
+// the phone takes every message straight away
+AppMessageResult app_message_outbox_send(void) {
+    s_outbox_open = false;
+    s_messages_sent++;
+    return APP_MSG_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, uint32_t key, const uint8_t *data, uint16_t size) {
+    iter->tuples++;
+    return DICT_OK;
+}
+
+DictionaryResult dict_write_int(DictionaryIterator *iter, uint32_t key, const void *integer, uint8_t width, bool is_signed) {
+    iter->tuples++;
+    return DICT_OK;
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value) {
+    iter->tuples++;
+    return DICT_OK;
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter) {
+    return iter->tuples;
+}
+
+uint32_t dict_calc_buffer_size(uint8_t tuple_count, ...) {
+    va_list sizes;
+    uint32_t total = 1;
+    va_start(sizes, tuple_count);
+    for (uint8_t i = 0; i < tuple_count; ++i) {
+        total += sizeof(Tuple) + va_arg(sizes, uint32_t);
+    }
+    va_end(sizes);
+    return total;
+}
+
+uint32_t host_messages_sent(void) {
+    return s_messages_sent;
+}
+
+// build the tuple the phone would send and hand it to the AppSync callback
+static void sync_deliver(const Tuplet *tuplet) {
+    uint16_t length = (tuplet->type == TUPLE_BYTE_ARRAY) ? tuplet->bytes.length :
+                      (tuplet->type == TUPLE_CSTRING) ? tuplet->cstring.length : tuplet->integer.width;
+    Tuple *tuple = calloc(1, sizeof(Tuple) + length + 4);
+    if (!tuple || !s_sync) {
+        free(tuple);
+        return;
+    }
+    tuple->key = tuplet->key;
+    tuple->type = tuplet->type;
+    tuple->length = length;
+    if (tuplet->type == TUPLE_BYTE_ARRAY) {
+        memcpy(tuple->value->data, tuplet->bytes.data, length);
+    }
+    else if (tuplet->type == TUPLE_CSTRING) {
+        memcpy(tuple->value->cstring, tuplet->cstring.data, length);
+    }
+    else {
+        memcpy(tuple->value->data, &tuplet->integer.storage, length); // little endian like the watch
+    }
+    s_sync->tuple_changed(tuple->key, tuple, NULL, s_sync->context);
+    free(tuple);
+}
+
+// the initial values come back through the callback, like on the watch
+void app_sync_init(AppSync *s, uint8_t *buffer, const uint16_t buffer_size, const Tuplet *const keys_and_initial_values,
+                   const uint8_t count, AppSyncTupleChangedCallback tuple_changed_callback,
+                   AppSyncErrorCallback error_callback, void *context) {
+    *s = (AppSync){ tuple_changed_callback, error_callback, context };
+    s_sync = s;
+    for (uint8_t i = 0; i < count; ++i) {
+        sync_deliver(&keys_and_initial_values[i]);
+    }
+}
+
+void app_sync_deinit(AppSync *s) {
+    s_sync = NULL;
+}
+
+void host_sync_update(const Tuplet *tuplet) {
+    sync_deliver(tuplet);
+    host_render();
+}
+
+
+//======================================
+// TESTS
+//======================================
+static uint32_t s_checks = 0, s_failures = 0;
+
+bool host_check(bool ok, const char *file, int line, const char *expression) {
+    s_checks++;
+    if (!ok) {
+        s_failures++;
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+    return ok;
+}
+
+int host_test_result(const char *name) {
+    printf("%s: %u checks, %u failed\n", name, s_checks, s_failures);
+    return (s_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+//======================================
+// APP
+//======================================
+// debug messages only with HOST_LOG set in the environment
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+    if ((log_level > APP_LOG_LEVEL_WARNING) && !getenv("HOST_LOG")) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "[%s:%d] ", src_filename, src_line_number);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+// the face's main() runs this between init and deinit: HOST_SECONDS of clock
+// (default 60), then the last frame goes to HOST_SCREENSHOT if that is set
+void app_event_loop(void) {
+    const char *seconds = getenv("HOST_SECONDS");
+    const char *screenshot = getenv("HOST_SCREENSHOT");
+    host_render();
+    host_advance(seconds ? strtoul(seconds, NULL, 10) : 60);
+    if (screenshot && !host_bitmap_write_ppm(screenshot, host_frame_buffer())) {
+        fprintf(stderr, "host: can't write %s\n", screenshot);
+    }
+}
@@ -0,0 +1,120 @@
+//======================================
+// TECHRAD host test: second hand frames
+// Every frame that only moves the second hand must leave the same pixels as
+// a full frame drawn over a scribbled frame buffer, with labels and icons
+// under the hands, and after a notification covered the face
+//======================================
+
+#include "host.h"
+
+#define main techrad_main
+#include "techrad.c"
+#undef main
+
+// the frame buffer as a full frame draws it from nothing, compared with what is there now
+static uint32_t differs_from_full_frame(GPoint *first) {
+    GBitmap *drawn = host_bitmap_copy(host_frame_buffer());
+    host_frame_buffer_scribble();
+    redraw_all();
+    host_render();
+    uint32_t pixels = host_bitmap_diff(drawn, host_frame_buffer(), first);
+    gbitmap_destroy(drawn);
+    return pixels;
+}
+
+// weather everywhere the hands and the second hand go
+static void weather_fill(void) {
+    format_text(cachedWeather.city, sizeof(cachedWeather.city), "Helsinki Vantaa");
+    format_text(cachedWeather.suntimes, sizeof(cachedWeather.suntimes), "6:12\n18:03");
+    format_text(cachedWeather.minmaxtemp, sizeof(cachedWeather.minmaxtemp), "-3-4°");
+    format_text(cachedWeather.misc, sizeof(cachedWeather.misc), "12 km/h");
+    format_temperature(cachedWeather.temperature, sizeof(cachedWeather.temperature), -3);
+    cachedWeather.icon_current = WEATHER_ICON_SNOW;
+    cachedWeather.forecasticon = WEATHER_ICON_CLOUD;
+    s_weather_loading = false;
+    weather_show();
+    host_render();
+}
+
+// two minutes of second hand frames, every one that only moves the second hand is partial,
+// also when the old hand crossed a label or an icon and those are drawn again
+static void test_seconds(void) {
+    uint32_t partial = 0, labels = 0, full = 0, wrong = 0;
+    GPoint first = GPointZero;
+    host_sync_update(&TupletInteger(CONFIG_SECONDSWINDOW, (uint8_t)0));
+    host_sync_update(&TupletInteger(CONFIG_SECONDS, (uint8_t)1));
+    host_render();
+
+    for (int i = 0; i < 120; i++) {
+        bool second_only = s_frame_time.tm_sec != 59;
+        if (second_only && compositor_partial_possible()) {
+            partial++;
+            labels += s_compositor_damage != 0;
+        }
+        else if (second_only) {
+            full++;
+        }
+        host_advance(1);
+        uint32_t pixels = differs_from_full_frame(&first);
+        if (pixels && !wrong) {
+            fprintf(stderr, "%02d:%02d:%02d: %u pixels differ from a full frame, first at %d,%d\n",
+                    s_frame_time.tm_hour, s_frame_time.tm_min, s_frame_time.tm_sec, pixels, first.x, first.y);
+        }
+        wrong += pixels != 0;
+    }
+    HOST_CHECK(wrong == 0);
+    HOST_CHECK(partial == 118); // all but the two minute ticks
+    HOST_CHECK(full == 0);
+    HOST_CHECK(labels >= 60); // the hands and labels fill most of the dial
+}
+
+// a notification over the face, the first frames after it are full ones
+static void test_overlay(void) {
+    host_overlay_show();
+    host_advance(3);
+    host_overlay_hide();
+    HOST_CHECK(differs_from_full_frame(NULL) == 0);
+
+    host_advance(1);
+    host_overlay_show();
+    host_overlay_hide();
+    HOST_CHECK(differs_from_full_frame(NULL) == 0);
+}
+
+// a dial cache that doesn't match the frame buffer is never blitted, the next full frame
+// draws the dial and replaces the cache with one of the frame buffer's format and size
+static void test_dial_cache_layout(void) {
+    GBitmapFormat screen_format = gbitmap_get_format(host_frame_buffer());
+    GBitmapFormat other = (screen_format == GBitmapFormat8Bit) ? GBitmapFormat1Bit : GBitmapFormat8Bit;
+    GBitmap *wrong[] = {
+        gbitmap_create_blank(GSize(HOST_SCREEN_W, HOST_SCREEN_H), other),
+        gbitmap_create_blank(GSize(HOST_SCREEN_W, HOST_SCREEN_H / 2), screen_format),
+    };
+    for (size_t i = 0; i < ARRAY_LENGTH(wrong); i++) {
+        gbitmap_destroy(s_dial_cache);
+        s_dial_cache = wrong[i];
+        s_dial_cache_valid = true; // as if a blit were allowed
+        HOST_CHECK(differs_from_full_frame(NULL) == 0);
+        HOST_CHECK(s_dial_cache_valid);
+        HOST_CHECK(gbitmap_get_format(s_dial_cache) == screen_format);
+        GRect cache_bounds = gbitmap_get_bounds(s_dial_cache), screen_bounds = gbitmap_get_bounds(host_frame_buffer());
+        HOST_CHECK(grect_equal(&cache_bounds, &screen_bounds));
+
+        host_frame_buffer_scribble(); // now from the new cache
+        redraw_all();
+        host_render();
+        HOST_CHECK(differs_from_full_frame(NULL) == 0);
+    }
+}
+
+int main(void) {
+    host_time_set(1457343000); // 09:30, the minute hand down through the city and the day
+    init();
+    host_render();
+    weather_fill();
+    test_seconds();
+    test_overlay();
+    test_dial_cache_layout();
+    deinit();
+    return host_test_result("compositor");
+}
@@ -0,0 +1,151 @@
+//======================================
+// TECHRAD host test: text formatting
+// Every formatter against the strings snprintf and strftime made before,
+// cut off values at small sizes, and with HOST_BENCH set the time per call
+// of both
+//======================================
+
+#include "host.h"
+#include "format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_TEXT(call, expected) do { \
+    char buffer[32]; \
+    size_t length = (call); \
+    HOST_CHECK(strcmp(buffer, (expected)) == 0); \
+    HOST_CHECK(length == strlen(expected)); \
+} while (0)
+
+static void test_int(void) {
+    CHECK_TEXT(format_int(buffer, sizeof(buffer), 0), "0");
+    CHECK_TEXT(format_int(buffer, sizeof(buffer), 7), "7");
+    CHECK_TEXT(format_int(buffer, sizeof(buffer), -12), "-12");
+    CHECK_TEXT(format_int(buffer, sizeof(buffer), INT32_MAX), "2147483647");
+    CHECK_TEXT(format_int(buffer, sizeof(buffer), INT32_MIN), "-2147483648");
+}
+
+static void test_temperature(void) {
+    CHECK_TEXT(format_temperature(buffer, sizeof(buffer), 21), "21°");
+    CHECK_TEXT(format_temperature(buffer, sizeof(buffer), 0), "0°");
+    CHECK_TEXT(format_temperature(buffer, sizeof(buffer), -5), "-5°");
+    CHECK_TEXT(format_temperature(buffer, sizeof(buffer), -40), "-40°");
+    CHECK_TEXT(format_temperature(buffer, sizeof(buffer), INT32_MIN), "-2147483648°");
+}
+
+static void test_battery(void) {
+    CHECK_TEXT(format_battery(buffer, sizeof(buffer), 100, false, 0), "100");
+    CHECK_TEXT(format_battery(buffer, sizeof(buffer), 40, true, 2), "+40");
+    CHECK_TEXT(format_battery(buffer, sizeof(buffer), 10, false, 2), "10!!");
+    CHECK_TEXT(format_battery(buffer, sizeof(buffer), 0, false, 9), "0!!!");
+}
+
+static void test_fitness(void) {
+    CHECK_TEXT(format_fitness(buffer, sizeof(buffer), 0, false), "0x");
+    CHECK_TEXT(format_fitness(buffer, sizeof(buffer), 12345, false), "12345x");
+    CHECK_TEXT(format_fitness(buffer, sizeof(buffer), 8021, true), "8021 m");
+}
+
+static void test_day(void) {
+    struct tm t = { .tm_wday = 1, .tm_mday = 7 };
+    CHECK_TEXT(format_day(buffer, sizeof(buffer), &t), "Mon 07");
+    t.tm_wday = 6;
+    t.tm_mday = 31;
+    CHECK_TEXT(format_day(buffer, sizeof(buffer), &t), "Sat 31");
+}
+
+// midnight and noon are 12 in 12 hour style
+static void test_clock(void) {
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 0, 0, false), "12:00 AM");
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 0, 0, true), "0:00");
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 11, 59, false), "11:59 AM");
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 12, 0, false), "12:00 PM");
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 12, 5, true), "12:05");
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 13, 7, false), "1:07 PM");
+    CHECK_TEXT(format_clock(buffer, sizeof(buffer), 23, 59, true), "23:59");
+}
+
+// text is cut to size - 1 characters, nothing is written past size
+static void test_truncation(void) {
+    char buffer[8];
+    memset(buffer, '#', sizeof(buffer));
+    HOST_CHECK(format_int(buffer, 4, INT32_MIN) == 3);
+    HOST_CHECK(strcmp(buffer, "-21") == 0);
+    HOST_CHECK(buffer[4] == '#');
+
+    HOST_CHECK(format_int(buffer, 0, 5) == 0);
+    HOST_CHECK(buffer[0] == '-');
+    HOST_CHECK(format_int(buffer, 1, 5) == 0);
+    HOST_CHECK(buffer[0] == '\0');
+
+    HOST_CHECK(format_fitness(buffer, 4, 12345, true) == 3);
+    HOST_CHECK(strcmp(buffer, "123") == 0);
+    HOST_CHECK(format_clock(buffer, 6, 0, 0, false) == 5);
+    HOST_CHECK(strcmp(buffer, "12:00") == 0);
+
+    // the degree sign is two bytes and goes whole or not at all
+    HOST_CHECK(format_temperature(buffer, 5, -12) == 3);
+    HOST_CHECK(strcmp(buffer, "-12") == 0);
+    HOST_CHECK(format_temperature(buffer, 6, -12) == 5);
+    HOST_CHECK(strcmp(buffer, "-12°") == 0);
+    HOST_CHECK(format_temperature(buffer, 2, -12) == 1);
+    HOST_CHECK(strcmp(buffer, "-") == 0);
+
+    // appending to a full buffer writes nothing
+    size_t length = format_text(buffer, 4, "abcdef");
+    HOST_CHECK(length == 3);
+    HOST_CHECK(format_text(buffer + length, 4 - length, "x") == 0);
+    HOST_CHECK(strcmp(buffer, "abc") == 0);
+}
+
+
+//======================================
+// BENCHMARK
+//======================================
+#define BENCH_CALLS 1000000
+
+static volatile int32_t s_bench_value = 8021; // keeps the compiler from folding the calls
+static char s_bench_buffer[32];
+
+static double bench_now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+#define BENCH(name, call) do { \
+    double start = bench_now_ns(); \
+    for (int i = 0; i < BENCH_CALLS; i++) { \
+        call; \
+    } \
+    printf("  %-28s %6.1f ns/call\n", name, (bench_now_ns() - start) / BENCH_CALLS); \
+} while (0)
+
+static void bench(void) {
+    struct tm t = { .tm_wday = 1, .tm_mday = 7 };
+    printf("format benchmark, %d calls each\n", BENCH_CALLS);
+    BENCH("format_fitness", format_fitness(s_bench_buffer, sizeof(s_bench_buffer), s_bench_value, false));
+    BENCH("snprintf \"%dx\"", snprintf(s_bench_buffer, sizeof(s_bench_buffer), "%dx", (int)s_bench_value));
+    BENCH("format_battery", format_battery(s_bench_buffer, sizeof(s_bench_buffer), s_bench_value % 100, true, 0));
+    BENCH("snprintf \"+%d\"", snprintf(s_bench_buffer, sizeof(s_bench_buffer), "+%d", (int)s_bench_value % 100));
+    BENCH("format_temperature", format_temperature(s_bench_buffer, sizeof(s_bench_buffer), s_bench_value));
+    BENCH("snprintf \"%d°\"", snprintf(s_bench_buffer, sizeof(s_bench_buffer), "%d°", (int)s_bench_value));
+    BENCH("format_day", format_day(s_bench_buffer, sizeof(s_bench_buffer), &t));
+    BENCH("strftime \"%a %d\"", strftime(s_bench_buffer, sizeof(s_bench_buffer), "%a %d", &t));
+}
+
+int main(void) {
+    test_int();
+    test_temperature();
+    test_battery();
+    test_fitness();
+    test_day();
+    test_clock();
+    test_truncation();
+    if (getenv("HOST_BENCH")) {
+        bench();
+    }
+    return host_test_result("format");
+}
@@ -0,0 +1,252 @@
+//======================================
+// TECHRAD host test: hand rasterizer
+// Hands at a few angles drawn into a bitmap of the platform's frame
+// buffer format, 1 bit on aplite and 8 bit on basalt, against one golden
+// picture for both. HOST_GOLDEN_UPDATE=1 writes the picture instead.
+//======================================
+
+#include "host.h"
+#include "hand_raster.h"
+#include "hand_poses.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define GOLDEN_PATH "golden/hand_raster.txt"
+#define GOLDEN_MAX 65536
+
+#ifdef PBL_COLOR
+#define RASTER_FORMAT GBitmapFormat8Bit
+#else
+#define RASTER_FORMAT GBitmapFormat1Bit
+#endif
+
+static const GPoint CENTER = { HOST_SCREEN_W / 2, HOST_SCREEN_H / 2 };
+
+static char s_picture[GOLDEN_MAX];
+static size_t s_picture_length = 0;
+
+static void picture_add(const char *text) {
+    size_t length = strlen(text);
+    if (s_picture_length + length < sizeof(s_picture)) {
+        memcpy(s_picture + s_picture_length, text, length + 1);
+        s_picture_length += length;
+    }
+}
+
+// a black frame buffer sized bitmap, blank 8 bit bitmaps start out clear
+static GBitmap *bitmap_black(void) {
+    GBitmap *bitmap = gbitmap_create_blank(GSize(HOST_SCREEN_W, HOST_SCREEN_H), RASTER_FORMAT);
+    GRect bounds = gbitmap_get_bounds(bitmap);
+    memset(gbitmap_get_data(bitmap), (RASTER_FORMAT == GBitmapFormat8Bit) ? GColorBlack.argb : 0x00,
+           gbitmap_get_bytes_per_row(bitmap) * bounds.size.h);
+    return bitmap;
+}
+
+static bool lit(const GBitmap *bitmap, int16_t x, int16_t y) {
+    return !gcolor_equal(host_pixel(bitmap, x, y), GColorBlack);
+}
+
+static uint32_t lit_count(const GBitmap *bitmap) {
+    uint32_t pixels = 0;
+    for (int16_t y = 0; y < HOST_SCREEN_H; ++y) {
+        for (int16_t x = 0; x < HOST_SCREEN_W; ++x) {
+            pixels += lit(bitmap, x, y);
+        }
+    }
+    return pixels;
+}
+
+// the box around everything lit in either bitmap, one pixel of margin
+static GRect lit_box(const GBitmap *a, const GBitmap *b) {
+    int16_t x0 = HOST_SCREEN_W, y0 = HOST_SCREEN_H, x1 = -1, y1 = -1;
+    for (int16_t y = 0; y < HOST_SCREEN_H; ++y) {
+        for (int16_t x = 0; x < HOST_SCREEN_W; ++x) {
+            if (lit(a, x, y) || (b && lit(b, x, y))) {
+                x0 = (x < x0) ? x : x0;
+                x1 = (x > x1) ? x : x1;
+                y0 = (y < y0) ? y : y0;
+                y1 = (y > y1) ? y : y1;
+            }
+        }
+    }
+    if (x1 < 0) {
+        return GRect(0, 0, 0, 0);
+    }
+    x0 = (x0 > 0) ? x0 - 1 : x0;
+    y0 = (y0 > 0) ? y0 - 1 : y0;
+    x1 = (x1 < HOST_SCREEN_W - 1) ? x1 + 1 : x1;
+    y1 = (y1 < HOST_SCREEN_H - 1) ? y1 + 1 : y1;
+    return GRect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+// '#' fill, 'o' outline, '.' neither, the outline is drawn over the fill
+static void picture_add_hand(const char *name, const GBitmap *fill, const GBitmap *stroke) {
+    char line[HOST_SCREEN_W + 2];
+    GRect box = lit_box(fill, stroke);
+    snprintf(line, sizeof(line), "%s at %d,%d %dx%d\n", name, box.origin.x, box.origin.y, box.size.w, box.size.h);
+    picture_add(line);
+    for (int16_t y = box.origin.y; y < box.origin.y + box.size.h; ++y) {
+        int16_t length = 0;
+        for (int16_t x = box.origin.x; x < box.origin.x + box.size.w; ++x) {
+            line[length++] = (stroke && lit(stroke, x, y)) ? 'o' : (lit(fill, x, y) ? '#' : '.');
+        }
+        line[length++] = '\n';
+        line[length] = '\0';
+        picture_add(line);
+    }
+    picture_add("\n");
+}
+
+// even-odd test of the pixel center, the reference for the fill
+static bool inside(const int8_t (*points)[2], uint8_t count, int16_t x, int16_t y) {
+    bool in = false;
+    for (uint8_t i = 0, j = count - 1; i < count; j = i++) {
+        int16_t xi = points[i][0], yi = points[i][1], xj = points[j][0], yj = points[j][1];
+        if (((yi > y) != (yj > y)) && (x * (yj - yi) < xi * (yj - yi) + (y - yi) * (xj - xi)) == (yj > yi)) {
+            in = !in;
+        }
+    }
+    return in;
+}
+
+// fill and outline in separate passes so both show on 1 bit, then together:
+// every pixel is written where the two passes say, and the returned counts add up
+static void hand(const char *name, const int8_t (*points)[2], uint8_t count) {
+    GBitmap *fill = bitmap_black(), *stroke = bitmap_black(), *both = bitmap_black();
+    uint32_t fill_pixels = hand_raster_polygon(fill, CENTER, points, count, GColorWhite, GColorClear, NULL);
+    uint32_t stroke_pixels = hand_raster_polygon(stroke, CENTER, points, count, GColorClear, GColorWhite, NULL);
+    HOST_CHECK(fill_pixels >= lit_count(fill)); // spans meeting on a pixel center both write it
+    HOST_CHECK(stroke_pixels >= lit_count(stroke)); // edges meet at the corners
+    HOST_CHECK(fill_pixels > 0);
+
+    // away from the outline the fill is exactly the pixels whose centers are inside
+    uint32_t misses = 0;
+    for (int16_t y = 0; y < HOST_SCREEN_H; ++y) {
+        for (int16_t x = 0; x < HOST_SCREEN_W; ++x) {
+            misses += !lit(stroke, x, y) && (lit(fill, x, y) != inside(points, count, x - CENTER.x, y - CENTER.y));
+        }
+    }
+    HOST_CHECK(misses == 0);
+
+    uint32_t both_pixels = hand_raster_polygon(both, CENTER, points, count, GColorWhite, GColorBlack, NULL);
+    HOST_CHECK(both_pixels == fill_pixels + stroke_pixels);
+    uint32_t wrong = 0;
+    for (int16_t y = 0; y < HOST_SCREEN_H; ++y) {
+        for (int16_t x = 0; x < HOST_SCREEN_W; ++x) {
+            wrong += lit(both, x, y) != (lit(fill, x, y) && !lit(stroke, x, y));
+        }
+    }
+    HOST_CHECK(wrong == 0);
+
+    picture_add_hand(name, fill, stroke);
+    gbitmap_destroy(fill);
+    gbitmap_destroy(stroke);
+    gbitmap_destroy(both);
+}
+
+static void second_hand(const char *name, uint8_t second, uint8_t width) {
+    HandRasterRows rows;
+    GBitmap *line = bitmap_black();
+    GPoint tip = GPoint(CENTER.x + SECOND_HAND_POSE[second][0], CENTER.y + SECOND_HAND_POSE[second][1]);
+    hand_raster_line_rows(tip, CENTER, width, &rows);
+    HOST_CHECK(hand_raster_fill_rows(line, &rows, GColorWhite) == lit_count(line));
+    picture_add_hand(name, line, NULL);
+    gbitmap_destroy(line);
+}
+
+// the minute hand limited to the rows of a second hand crossing it writes nothing outside them
+static void test_clip(void) {
+    HandRasterRows rows;
+    GBitmap *clipped = bitmap_black();
+    hand_raster_line_rows(GPoint(CENTER.x + SECOND_HAND_POSE[5][0], CENTER.y + SECOND_HAND_POSE[5][1]), CENTER, 2, &rows);
+    uint32_t pixels = hand_raster_polygon(clipped, CENTER, MINUTE_HAND_POSE[5], MINUTE_HAND_POSE_POINTS,
+                                          GColorWhite, GColorClear, &rows);
+    HOST_CHECK(pixels > 0);
+    HOST_CHECK(pixels >= lit_count(clipped));
+    uint32_t outside = 0;
+    for (int16_t y = 0; y < HOST_SCREEN_H; ++y) {
+        for (int16_t x = 0; x < HOST_SCREEN_W; ++x) {
+            int16_t row = y - rows.top;
+            bool inside = (row >= 0) && (row < rows.count) && (x >= rows.x0[row]) && (x <= rows.x1[row]);
+            outside += lit(clipped, x, y) && !inside;
+        }
+    }
+    HOST_CHECK(outside == 0);
+    gbitmap_destroy(clipped);
+}
+
+// frame buffers of another format or too many rows are left alone, the face draws GPath there
+static void test_unsupported(void) {
+    static const int8_t square[4][2] = { { -5, -5 }, { 5, -5 }, { 5, 5 }, { -5, 5 } };
+    HandRasterRows rows;
+    hand_raster_line_rows(GPoint(0, 0), GPoint(20, 20), 1, &rows);
+
+    GBitmap *screen = bitmap_black();
+    HOST_CHECK(hand_raster_supported(screen));
+    gbitmap_destroy(screen);
+
+    GBitmapFormat other = (RASTER_FORMAT == GBitmapFormat8Bit) ? GBitmapFormat1Bit : GBitmapFormat8Bit;
+    GBitmap *wrong_format = gbitmap_create_blank(GSize(HOST_SCREEN_W, HOST_SCREEN_H), other);
+    GBitmap *too_tall = gbitmap_create_blank(GSize(180, HAND_RASTER_MAX_ROWS + 12), RASTER_FORMAT);
+    GBitmap *bitmaps[] = { wrong_format, too_tall };
+    for (size_t i = 0; i < ARRAY_LENGTH(bitmaps); i++) {
+        size_t size = gbitmap_get_bytes_per_row(bitmaps[i]) * gbitmap_get_bounds(bitmaps[i]).size.h;
+        uint8_t *data = gbitmap_get_data(bitmaps[i]);
+        HOST_CHECK(!hand_raster_supported(bitmaps[i]));
+        HOST_CHECK(hand_raster_polygon(bitmaps[i], CENTER, square, 4, GColorWhite, GColorWhite, NULL) == 0);
+        HOST_CHECK(hand_raster_fill_rows(bitmaps[i], &rows, GColorWhite) == 0);
+        size_t written = 0;
+        for (size_t j = 0; j < size; j++) {
+            written += data[j] != 0;
+        }
+        HOST_CHECK(written == 0);
+        gbitmap_destroy(bitmaps[i]);
+    }
+}
+
+static void test_golden(void) {
+    if (getenv("HOST_GOLDEN_UPDATE")) {
+        FILE *out = fopen(GOLDEN_PATH, "w");
+        HOST_CHECK(out != NULL);
+        if (out) {
+            fputs(s_picture, out);
+            fclose(out);
+        }
+        return;
+    }
+    static char golden[GOLDEN_MAX];
+    FILE *in = fopen(GOLDEN_PATH, "r");
+    HOST_CHECK(in != NULL);
+    if (!in) {
+        return;
+    }
+    size_t length = fread(golden, 1, sizeof(golden) - 1, in);
+    fclose(in);
+    golden[length] = '\0';
+    HOST_CHECK(length == s_picture_length);
+    HOST_CHECK(strcmp(golden, s_picture) == 0);
+    if (strcmp(golden, s_picture) != 0) {
+        fputs(s_picture, stderr); // what was drawn, for a diff against the golden file
+    }
+}
+
+int main(void) {
+    static const uint8_t minutes[] = { 0, 7, 15, 22, 38, 53 };
+    static const uint8_t hours[] = { 0, 17, 40, 100 }; // 12:00, 1:25, 3:20, 8:20
+    char name[24];
+    for (size_t i = 0; i < ARRAY_LENGTH(minutes); i++) {
+        snprintf(name, sizeof(name), "minute %d", minutes[i]);
+        hand(name, MINUTE_HAND_POSE[minutes[i]], MINUTE_HAND_POSE_POINTS);
+    }
+    for (size_t i = 0; i < ARRAY_LENGTH(hours); i++) {
+        snprintf(name, sizeof(name), "hour pose %d", hours[i]);
+        hand(name, HOUR_HAND_POSE[hours[i]], HOUR_HAND_POSE_POINTS);
+    }
+    second_hand("second 13 width 1", 13, 1);
+    second_hand("second 41 width 2", 41, 2);
+    test_clip();
+    test_unsupported();
+    test_golden();
+    return host_test_result("hand_raster");
+}
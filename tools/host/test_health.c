@@ -0,0 +1,64 @@
+//======================================
+// TECHRAD host test: health totals
+// Movement updates while walking don't query the health service,
+// the minute tick reads the totals at most once
+//======================================
+
+#include "host.h"
+
+#define main techrad_main
+#include "techrad.c"
+#undef main
+
+#if defined(PBL_HEALTH)
+// run to just past the next minute tick
+static void advance_to_minute(void) {
+    host_advance(60 - s_frame_time.tm_sec);
+}
+
+// subscribing is a significant update, the totals are read right away
+static void test_subscribe(void) {
+    HOST_CHECK(s_health_steps == 1200);
+    HOST_CHECK(strcmp(s_fitness_buffer, "1200x") == 0);
+}
+
+// a minute of walking: many movement updates, one read of steps and distance
+static void test_walking(void) {
+    uint32_t queries = host_health_queries();
+    for (int i = 1; i <= 50; i++) {
+        host_health_set(HealthMetricStepCount, 1200 + i);
+        host_health_event(HealthEventMovementUpdate);
+    }
+    HOST_CHECK(host_health_queries() == queries);
+    HOST_CHECK(strcmp(s_fitness_buffer, "1200x") == 0);
+
+    advance_to_minute();
+    HOST_CHECK(host_health_queries() - queries == 2);
+    HOST_CHECK(strcmp(s_fitness_buffer, "1250x") == 0);
+}
+
+// no movement, no reads; movement that didn't add steps reads steps only
+static void test_still(void) {
+    uint32_t queries = host_health_queries();
+    host_advance(5 * 60);
+    HOST_CHECK(host_health_queries() == queries);
+
+    host_health_event(HealthEventMovementUpdate);
+    advance_to_minute();
+    HOST_CHECK(host_health_queries() - queries == 1);
+}
+#endif
+
+int main(void) {
+    #if defined(PBL_HEALTH)
+    host_health_set(HealthMetricStepCount, 1200);
+    host_health_set(HealthMetricWalkedDistanceMeters, 900);
+    init();
+    host_render();
+    test_subscribe();
+    test_walking();
+    test_still();
+    deinit();
+    #endif
+    return host_test_result("health");
+}
@@ -0,0 +1,144 @@
+//======================================
+// TECHRAD host test: job scheduler
+// Minute ticks in order, skipped ticks, and the wall clock
+// jumping ahead or being set back
+//======================================
+
+#include "host.h"
+#include "scheduler.h"
+
+static int s_hourly_runs, s_daily_runs, s_three_hourly_runs;
+
+static void hourly(void) { s_hourly_runs++; }
+static void daily(void) { s_daily_runs++; }
+static void three_hourly(void) { s_three_hourly_runs++; }
+
+static SchedulerJob s_hourly = { .name = "hourly", .callback = hourly, .period = 60, .offset = 0 };
+static SchedulerJob s_daily = { .name = "daily", .callback = daily, .period = 24 * 60, .offset = 0 };
+static SchedulerJob s_three_hourly = { .name = "three hourly", .callback = three_hourly, .period = 180, .offset = 0 };
+
+// the watch's wall clock, localtime runs in UTC on the host
+static time_t s_clock;
+
+static void tick(void) {
+    scheduler_tick(localtime(&s_clock));
+}
+
+// a tick for every minute up to and including until
+static void tick_minutes_until(time_t until) {
+    while (s_clock < until) {
+        s_clock += 60;
+        tick();
+    }
+}
+
+static void runs_reset(void) {
+    s_hourly_runs = 0;
+    s_daily_runs = 0;
+    s_three_hourly_runs = 0;
+}
+
+// 2016-03-07 09:41 to 12:00, then the clock set back half an hour and run to 12:00 again
+static void test_set_back(void) {
+    s_clock = 1457343660;
+    scheduler_init(localtime(&s_clock));
+    scheduler_add(&s_hourly);
+    scheduler_add(&s_daily);
+
+    tick_minutes_until(1457352000); // 12:00
+    HOST_CHECK(s_hourly_runs == 3);
+    HOST_CHECK(s_daily_runs == 0);
+
+    runs_reset();
+    s_clock -= 30 * 60;
+    tick();
+    HOST_CHECK(s_hourly_runs == 0);
+    tick_minutes_until(1457352000);
+    HOST_CHECK(s_hourly_runs == 1);
+}
+
+// the end of DST: 01:59 is followed by 01:00, the hour repeats
+static void test_fall_back(void) {
+    runs_reset();
+    tick_minutes_until(1457398740); // 2016-03-08 00:59
+    HOST_CHECK(s_hourly_runs == 12);
+    HOST_CHECK(s_daily_runs == 1);
+    runs_reset();
+
+    tick_minutes_until(1457402340); // 01:59
+    HOST_CHECK(s_hourly_runs == 1);
+    s_clock = 1457398800; // 01:00 again
+    tick();
+    HOST_CHECK(s_hourly_runs == 1);
+    tick_minutes_until(1457402400); // 02:00
+    HOST_CHECK(s_hourly_runs == 2);
+    HOST_CHECK(s_daily_runs == 0);
+}
+
+// asleep or the clock jumped ahead: one turn of the wheel runs each job that is due once
+static void test_jump_ahead(void) {
+    runs_reset();
+    s_clock += 5 * 60 * 60;
+    tick();
+    HOST_CHECK(s_hourly_runs == 1);
+    HOST_CHECK(s_daily_runs == 0);
+}
+
+// the new year is one minute after the old one, not a jump
+static void test_new_year(void) {
+    s_clock = 1483228740; // 2016-12-31 23:59
+    scheduler_remove(&s_hourly);
+    scheduler_remove(&s_daily);
+    scheduler_init(localtime(&s_clock));
+    scheduler_add(&s_hourly);
+    scheduler_add(&s_daily);
+
+    runs_reset();
+    tick_minutes_until(1483228800); // 2017-01-01 00:00
+    HOST_CHECK(s_hourly_runs == 1);
+    HOST_CHECK(s_daily_runs == 1);
+    tick_minutes_until(1483228800 + 59 * 60);
+    HOST_CHECK(s_hourly_runs == 1);
+}
+
+// jobs longer than the wheel keep their wall clock minutes across a jump:
+// a run that came due in the gap happens once, the next one on time
+static void test_long_jump(void) {
+    scheduler_remove(&s_hourly);
+    scheduler_remove(&s_daily);
+    s_clock = 1457343660; // 2016-03-07 09:41
+    scheduler_init(localtime(&s_clock));
+    scheduler_add(&s_three_hourly);
+    scheduler_add(&s_daily);
+    runs_reset();
+
+    s_clock += 5 * 60 * 60; // 14:41, 12:00 was missed
+    tick();
+    HOST_CHECK(s_three_hourly_runs == 1);
+    HOST_CHECK(s_daily_runs == 0);
+    tick_minutes_until(1457362740); // 14:59
+    HOST_CHECK(s_three_hourly_runs == 1);
+    tick_minutes_until(1457362800); // 15:00
+    HOST_CHECK(s_three_hourly_runs == 2);
+
+    s_clock = 1457400600; // 2016-03-08 01:30, 18:00 to 00:00 and midnight missed
+    tick();
+    HOST_CHECK(s_three_hourly_runs == 3);
+    HOST_CHECK(s_daily_runs == 1);
+    tick_minutes_until(1457405940); // 02:59
+    HOST_CHECK(s_three_hourly_runs == 3);
+    tick_minutes_until(1457406000); // 03:00
+    HOST_CHECK(s_three_hourly_runs == 4);
+    scheduler_remove(&s_three_hourly);
+    scheduler_remove(&s_daily);
+}
+
+int main(void) {
+    test_set_back();
+    test_fall_back();
+    test_jump_ahead();
+    test_new_year();
+    test_long_jump();
+    scheduler_deinit();
+    return host_test_result("scheduler");
+}
@@ -0,0 +1,177 @@
+//======================================
+// TECHRAD host test: persistent storage
+// The face's settings and weather records through storage_load and
+// storage_flush: round trips, write-behind, corrupt and short records
+// that must leave the live struct alone, and migration of old layouts
+//======================================
+
+#include "host.h"
+
+#define main techrad_main
+#include "techrad.c"
+#undef main
+
+#define HEADER_SIZE 4 // magic, version, CRC-16 little endian
+
+// the CRC storage.c puts in the header, CRC-16/CCITT-FALSE
+static uint16_t crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+// a record with a header for payload, as an older or newer face wrote it
+static void write_record(uint32_t key, uint8_t version, const void *payload, size_t size) {
+    uint8_t buffer[PERSIST_DATA_MAX_LENGTH];
+    uint16_t crc = crc16(payload, size);
+    buffer[0] = 0xA5;
+    buffer[1] = version;
+    buffer[2] = crc & 0xFF;
+    buffer[3] = crc >> 8;
+    memcpy(buffer + HEADER_SIZE, payload, size);
+    persist_write_data(key, buffer, HEADER_SIZE + size);
+}
+
+static const persist SENTINEL_SETTINGS = { 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE };
+
+static bool settings_untouched(void) {
+    return memcmp(&settings, &SENTINEL_SETTINGS, sizeof(settings)) == 0;
+}
+
+static void settings_store_good(void) {
+    settings = (persist){ .seconds = 1, .hourvibes = 1, .reverse = 0, .distance = 1, .bluetheme = 1, .secondswindow = 7 };
+    storage_mark_dirty(&s_settings_store);
+    HOST_CHECK(storage_flush(&s_settings_store, true));
+}
+
+static void test_round_trip(void) {
+    HOST_CHECK(!storage_load(&s_settings_store)); // nothing stored yet
+    settings_store_good();
+    HOST_CHECK(persist_get_size(PERSIST_SETTINGS) == HEADER_SIZE + (int)sizeof(persist));
+    settings = SENTINEL_SETTINGS;
+    HOST_CHECK(storage_load(&s_settings_store));
+    HOST_CHECK((settings.seconds == 1) && (settings.distance == 1) && (settings.secondswindow == 7));
+    HOST_CHECK(!s_settings_store.dirty);
+}
+
+// repeated changes within STORAGE_FLUSH_MINUTES cost one write
+static void test_write_behind(void) {
+    settings_store_good();
+    storage_mark_dirty(&s_settings_store);
+    HOST_CHECK(!storage_flush(&s_settings_store, false));
+    host_time_set(time(NULL) + STORAGE_FLUSH_MINUTES * 60);
+    HOST_CHECK(storage_flush(&s_settings_store, false));
+    HOST_CHECK(!storage_flush(&s_settings_store, false)); // clean now
+}
+
+// a flipped bit in the payload or in the stored CRC
+static void test_bad_crc(void) {
+    uint8_t stored[PERSIST_DATA_MAX_LENGTH];
+    settings_store_good();
+    int size = persist_read_data(PERSIST_SETTINGS, stored, sizeof(stored));
+
+    stored[HEADER_SIZE + 2] ^= 0x01;
+    persist_write_data(PERSIST_SETTINGS, stored, size);
+    settings = SENTINEL_SETTINGS;
+    HOST_CHECK(!storage_load(&s_settings_store));
+    HOST_CHECK(settings_untouched());
+
+    stored[HEADER_SIZE + 2] ^= 0x01;
+    stored[2] ^= 0x80;
+    persist_write_data(PERSIST_SETTINGS, stored, size);
+    HOST_CHECK(!storage_load(&s_settings_store));
+    HOST_CHECK(settings_untouched());
+}
+
+// reads cut short, and a record torn before it was whole
+static void test_short(void) {
+    settings_store_good();
+    settings = SENTINEL_SETTINGS;
+    host_persist_short_read(HEADER_SIZE + 2);
+    HOST_CHECK(!storage_load(&s_settings_store));
+    HOST_CHECK(settings_untouched());
+
+    host_persist_short_read(2); // not even a whole header, looks like a headerless record
+    HOST_CHECK(!storage_load(&s_settings_store));
+    HOST_CHECK(settings_untouched());
+
+    static const uint8_t torn[3] = { 1, 0, 1 };
+    persist_write_data(PERSIST_SETTINGS, torn, sizeof(torn));
+    HOST_CHECK(!storage_load(&s_settings_store));
+    HOST_CHECK(settings_untouched());
+
+    cachedWeather.latitude = 1234;
+    write_record(PERSIST_WEATHERDATA, 1, &cachedWeather, 10); // version 1, but short
+    HOST_CHECK(!storage_load(&s_weather_store));
+    HOST_CHECK(cachedWeather.latitude == 1234);
+}
+
+// a newer face's record is left for it, the defaults stay
+static void test_newer_version(void) {
+    static const persist newer = { 1, 1, 1, 1, 1, 1 };
+    write_record(PERSIST_SETTINGS, SETTINGS_VERSION + 1, &newer, sizeof(newer));
+    settings = SENTINEL_SETTINGS;
+    HOST_CHECK(!storage_load(&s_settings_store));
+    HOST_CHECK(settings_untouched());
+}
+
+// settings from before headers, and version 1 without the seconds window
+static void test_migrate_settings(void) {
+    static const uint8_t v0[SETTINGS_V0_SIZE] = { 1, 0, 1, 0, 1 };
+    persist_write_data(PERSIST_SETTINGS, v0, sizeof(v0));
+    settings = (persist){ .secondswindow = 30 };
+    HOST_CHECK(storage_load(&s_settings_store));
+    HOST_CHECK((settings.seconds == 1) && (settings.reverse == 1) && (settings.bluetheme == 1));
+    HOST_CHECK(settings.secondswindow == 30);
+    HOST_CHECK(s_settings_store.dirty); // rewritten in the current layout
+
+    HOST_CHECK(storage_flush(&s_settings_store, true));
+    HOST_CHECK(persist_get_size(PERSIST_SETTINGS) == HEADER_SIZE + (int)sizeof(persist));
+    settings = SENTINEL_SETTINGS;
+    HOST_CHECK(storage_load(&s_settings_store));
+    HOST_CHECK((settings.seconds == 1) && (settings.secondswindow == 30));
+
+    static const uint8_t v1[SETTINGS_V0_SIZE] = { 0, 1, 0, 1, 0 };
+    write_record(PERSIST_SETTINGS, 1, v1, sizeof(v1));
+    HOST_CHECK(storage_load(&s_settings_store));
+    HOST_CHECK((settings.hourvibes == 1) && (settings.distance == 1) && (settings.secondswindow == 30));
+}
+
+// weather from before headers had a shorter temperature, version 1 no position
+static void test_migrate_weather(void) {
+    weatherdata_v0 v0 = { .icon_current = 2, .forecasticon = 3 };
+    strcpy(v0.temperature, "-5");
+    strcpy(v0.city, "Oslo");
+    persist_write_data(PERSIST_WEATHERDATA, &v0, sizeof(v0));
+    cachedWeather.latitude = 1234;
+    HOST_CHECK(storage_load(&s_weather_store));
+    HOST_CHECK((cachedWeather.icon_current == 2) && (cachedWeather.forecasticon == 3));
+    HOST_CHECK(strcmp(cachedWeather.temperature, "-5") == 0);
+    HOST_CHECK(strcmp(cachedWeather.city, "Oslo") == 0);
+    HOST_CHECK(cachedWeather.latitude == SUNTIMES_NO_LOCATION);
+
+    weatherdata v1 = { .icon_current = 1 };
+    strcpy(v1.city, "Bergen");
+    write_record(PERSIST_WEATHERDATA, 1, &v1, sizeof(v1) - 2 * sizeof(int16_t));
+    cachedWeather.latitude = 1234;
+    HOST_CHECK(storage_load(&s_weather_store));
+    HOST_CHECK(strcmp(cachedWeather.city, "Bergen") == 0);
+    HOST_CHECK(cachedWeather.latitude == SUNTIMES_NO_LOCATION);
+    HOST_CHECK(s_weather_store.dirty);
+}
+
+int main(void) {
+    test_round_trip();
+    test_write_behind();
+    test_bad_crc();
+    test_short();
+    test_newer_version();
+    test_migrate_settings();
+    test_migrate_weather();
+    return host_test_result("storage");
+}
@@ -0,0 +1,122 @@
+//======================================
+// TECHRAD host test: weather timeline
+// The face steps through the phone's forecast slots, until a record says
+// there is no data or comes from another place, then the slots are dropped
+// and the labels keep what the record says
+//======================================
+
+#include "host.h"
+
+#define main techrad_main
+#include "techrad.c"
+#undef main
+
+#define SLOT_HOURS 3
+
+static time_t s_start;
+
+static void record_send(const char *city, int16_t latitude, int8_t temperature, uint8_t flags) {
+    uint8_t data[sizeof(WeatherRecord) + WEATHER_CITY_MAX] = { 0 };
+    WeatherRecord *record = (WeatherRecord *)data;
+    record->version = WEATHER_RECORD_VERSION;
+    record->icon = WEATHER_ICON_SUN;
+    record->forecasticon = WEATHER_ICON_CLOUD;
+    record->flags = flags;
+    record->temperature = temperature;
+    record->temp_min = temperature - 2;
+    record->temp_max = temperature + 2;
+    record->wind = 10;
+    record->latitude = latitude;
+    record->longitude = 1075;
+    record->city_length = strlen(city);
+    memcpy(record->city, city, record->city_length);
+    host_sync_update(&TupletBytes(WEATHER_PACKED, data, sizeof(WeatherRecord) + record->city_length));
+}
+
+// slot i is 20 + i degrees, slot 0 covers now
+static void timeline_send(void) {
+    WeatherTimeline timeline = {
+        .version = WEATHER_TIMELINE_VERSION,
+        .step = SLOT_HOURS * 60,
+        .count = 8,
+        .start = s_start - 60,
+    };
+    for (int i = 0; i < timeline.count; i++) {
+        timeline.slots[i] = (WeatherSlot){ .icon = WEATHER_ICON_RAIN, .temperature = 20 + i, .wind = 5 };
+    }
+    host_sync_update(&TupletBytes(WEATHER_TIMELINE, (uint8_t *)&timeline,
+                                  offsetof(WeatherTimeline, slots) + timeline.count * sizeof(WeatherSlot)));
+}
+
+static bool temperature_is(const char *expected) {
+    return strcmp(cachedWeather.temperature, expected) == 0;
+}
+
+// a place with a timeline steps to its next slot, at the hourly job after the slot starts
+static void test_steps(void) {
+    record_send("Oslo", 5991, 5, 0);
+    timeline_send();
+    HOST_CHECK(s_timeline.count == 8);
+    HOST_CHECK(temperature_is("5°"));
+    host_advance(SLOT_HOURS * 60 * 60 + 30 * 60);
+    HOST_CHECK(temperature_is("21°"));
+
+    // the same place again keeps the slots
+    record_send("Oslo", 5991, 7, 0);
+    HOST_CHECK(s_timeline.count == 8);
+}
+
+static void test_no_data(void) {
+    record_send("no data", 5991, 0, WEATHER_FLAG_NO_DATA);
+    HOST_CHECK(s_timeline.count == 0);
+    HOST_CHECK(temperature_is(""));
+    host_advance(SLOT_HOURS * 60 * 60);
+    HOST_CHECK(temperature_is(""));
+    HOST_CHECK(strcmp(cachedWeather.city, "no data") == 0);
+}
+
+static void test_no_gps(void) {
+    record_send("Oslo", 5991, 5, 0);
+    timeline_send();
+    HOST_CHECK(s_timeline.count == 8);
+    record_send("no GPS", 5991, 0, WEATHER_FLAG_NO_GPS);
+    HOST_CHECK(s_timeline.count == 0);
+    host_advance(SLOT_HOURS * 60 * 60);
+    HOST_CHECK(temperature_is("GPS"));
+}
+
+// a new city, then only a new position under the same name
+static void test_moved(void) {
+    record_send("Oslo", 5991, 5, 0);
+    timeline_send();
+    record_send("Bergen", 6039, 9, 0);
+    HOST_CHECK(s_timeline.count == 0);
+    host_advance(SLOT_HOURS * 60 * 60);
+    HOST_CHECK(temperature_is("9°"));
+
+    timeline_send();
+    HOST_CHECK(s_timeline.count == 8);
+    record_send("Bergen", 6040, 9, 0);
+    HOST_CHECK(s_timeline.count == 0);
+}
+
+// without slots to step through the hourly job asks the phone again
+static void test_refetch(void) {
+    host_bluetooth_set(true);
+    uint32_t sent = host_messages_sent();
+    host_advance(60 * 60 + 10);
+    HOST_CHECK(host_messages_sent() > sent);
+}
+
+int main(void) {
+    init();
+    host_render();
+    s_start = time(NULL);
+    test_steps();
+    test_no_data();
+    test_no_gps();
+    test_moved();
+    test_refetch();
+    deinit();
+    return host_test_result("timeline");
+}
@@ -0,0 +1,63 @@
+//======================================
+// TECHRAD host test: the whole face
+// Runs init, a few hours of ticks with the second hand and deinit,
+// the face's statics are reachable because techrad.c is included
+//======================================
+
+#include "host.h"
+
+#define main techrad_main
+#include "techrad.c"
+#undef main
+
+// a pixel in the filled side of the minute hand, between the outline and the slot
+static GColor minute_hand_pixel(const struct tm *t) {
+    const int8_t (*pose)[2] = MINUTE_HAND_POSE[t->tm_min];
+    int16_t x = (pose[0][0] + pose[1][0] + pose[8][0] + pose[9][0]) / 4;
+    int16_t y = (pose[0][1] + pose[1][1] + pose[8][1] + pose[9][1]) / 4;
+    return host_pixel(host_frame_buffer(), HOST_SCREEN_W / 2 + x, HOST_SCREEN_H / 2 + y);
+}
+
+// the dial's background shows in the corner under the battery text, the hands over the dial
+static void test_first_frame(void) {
+    GBitmap *fb = host_frame_buffer();
+    HOST_CHECK(host_frames() == 1);
+    HOST_CHECK(gcolor_equal(host_pixel(fb, HOST_SCREEN_W - 1, HOST_SCREEN_H - 1), s_theme->background));
+    HOST_CHECK(s_dial_cache_valid);
+    HOST_CHECK(gcolor_equal(minute_hand_pixel(&s_frame_time), s_theme->hand_fill));
+}
+
+// an hour with the second hand on: a frame every second, one hour vibe, nothing leaks
+static void test_seconds_hour(void) {
+    host_sync_update(&TupletInteger(CONFIG_SECONDSWINDOW, (uint8_t)0));
+    host_sync_update(&TupletInteger(CONFIG_SECONDS, (uint8_t)1));
+    host_sync_update(&TupletInteger(CONFIG_HOURVIBES, (uint8_t)1));
+    HOST_CHECK(settings.seconds == 1);
+
+    size_t heap = heap_bytes_used();
+    uint32_t frames = host_frames(), vibes = host_vibes();
+    host_advance(60 * 60);
+    HOST_CHECK(host_frames() - frames >= 60 * 60);
+    HOST_CHECK(host_vibes() - vibes == 1);
+    HOST_CHECK(heap_bytes_used() == heap);
+}
+
+// per minute ticks once the second hand is off again
+static void test_minutes(void) {
+    host_sync_update(&TupletInteger(CONFIG_SECONDS, (uint8_t)0));
+    uint32_t frames = host_frames();
+    host_advance(10 * 60);
+    HOST_CHECK(host_frames() - frames == 10);
+    HOST_CHECK(gcolor_equal(minute_hand_pixel(&s_frame_time), s_theme->hand_fill));
+}
+
+int main(void) {
+    init();
+    host_render();
+    test_first_frame();
+    test_seconds_hour();
+    test_minutes();
+    deinit();
+    HOST_CHECK(heap_bytes_used() == 0);
+    return host_test_result("watchface");
+}
@@ -0,0 +1,128 @@
+//======================================
+// TECHRAD host test: weather icons
+// Every icon drawn by the face at both sizes, the 25 pixel current weather
+// and the 15 pixel forecast, against a golden picture per platform.
+// HOST_GOLDEN_UPDATE=1 writes the pictures instead. The pixels come from
+// this directory's stand-in drawing calls, so this checks the command lists
+// and their scaling, not what the firmware draws.
+//======================================
+
+#include "host.h"
+
+#define main techrad_main
+#include "techrad.c"
+#undef main
+
+#include <stdlib.h>
+
+#ifdef PBL_COLOR
+#define GOLDEN_PATH "golden/weather_icons_basalt.txt"
+#else
+#define GOLDEN_PATH "golden/weather_icons_aplite.txt"
+#endif
+#define GOLDEN_MAX 16384
+
+static char s_picture[GOLDEN_MAX];
+static size_t s_picture_length = 0;
+
+static void picture_add(const char *text) {
+    size_t length = strlen(text);
+    if (s_picture_length + length < sizeof(s_picture)) {
+        memcpy(s_picture + s_picture_length, text, length + 1);
+        s_picture_length += length;
+    }
+}
+
+// 's' sun, 'c' cloud, 'a' accent, '.' anything else, the first color that matches
+static char icon_pixel(int16_t x, int16_t y) {
+    GColor color = host_pixel(host_frame_buffer(), x, y);
+    const WeatherIconColors *icons = &s_theme->icons;
+    return gcolor_equal(color, icons->sun) ? 's' : gcolor_equal(color, icons->cloud) ? 'c' :
+           gcolor_equal(color, icons->accent) ? 'a' : '.';
+}
+
+static void picture_add_layer(const char *name, Layer *layer) {
+    char line[32];
+    GRect frame = layer_get_frame(layer);
+    snprintf(line, sizeof(line), "%s\n", name);
+    picture_add(line);
+    for (int16_t y = frame.origin.y; y < frame.origin.y + frame.size.h; ++y) {
+        int16_t length = 0;
+        for (int16_t x = frame.origin.x; x < frame.origin.x + frame.size.w; ++x) {
+            line[length++] = icon_pixel(x, y);
+        }
+        line[length++] = '\n';
+        line[length] = '\0';
+        picture_add(line);
+    }
+    picture_add("\n");
+}
+
+// each icon as the current weather and as the forecast, both drawn in one frame
+static void test_icons(void) {
+    static const char *const names[WEATHER_ICON_COUNT] = { "sun", "cloud", "rain", "snow", "loading" };
+    char name[32];
+    s_weather_loading = false;
+    for (uint8_t icon = 0; icon < WEATHER_ICON_COUNT; icon++) {
+        cachedWeather.icon_current = icon;
+        cachedWeather.forecasticon = icon;
+        weather_show();
+        HOST_CHECK(host_render());
+        snprintf(name, sizeof(name), "%s 25", names[icon]);
+        picture_add_layer(name, s_icon_layer);
+        snprintf(name, sizeof(name), "%s 15", names[icon]);
+        picture_add_layer(name, s_forecasticon_layer);
+    }
+}
+
+// every theme draws the same shapes, only the colors change
+static void test_themes(void) {
+    char first[GOLDEN_MAX];
+    memcpy(first, s_picture, s_picture_length + 1);
+    for (uint8_t theme = 1; theme < 4; theme++) {
+        settings.reverse = theme >> 1;
+        settings.bluetheme = theme & 1;
+        theme_switch();
+        s_picture_length = 0;
+        test_icons();
+        HOST_CHECK(strcmp(first, s_picture) == 0);
+    }
+    memcpy(s_picture, first, strlen(first) + 1);
+    s_picture_length = strlen(first);
+}
+
+static void test_golden(void) {
+    if (getenv("HOST_GOLDEN_UPDATE")) {
+        FILE *out = fopen(GOLDEN_PATH, "w");
+        HOST_CHECK(out != NULL);
+        if (out) {
+            fputs(s_picture, out);
+            fclose(out);
+        }
+        return;
+    }
+    static char golden[GOLDEN_MAX];
+    FILE *in = fopen(GOLDEN_PATH, "r");
+    HOST_CHECK(in != NULL);
+    if (!in) {
+        return;
+    }
+    size_t length = fread(golden, 1, sizeof(golden) - 1, in);
+    fclose(in);
+    golden[length] = '\0';
+    HOST_CHECK(strcmp(golden, s_picture) == 0);
+    if (strcmp(golden, s_picture) != 0) {
+        fputs(s_picture, stderr); // what was drawn, for a diff against the golden file
+    }
+}
+
+int main(void) {
+    init();
+    host_sync_update(&TupletInteger(CONFIG_SECONDS, (uint8_t)0)); // no second hand over the forecast icon
+    host_render();
+    test_icons();
+    test_themes();
+    test_golden();
+    deinit();
+    return host_test_result("weather_icons");
+}